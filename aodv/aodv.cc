@@ -411,6 +411,7 @@ AODV::rt_update(aodv_rt_entry *rt, u_int32_t seqnum, u_int16_t metric,
      rt->rt_flags = RTF_UP;
      rt->rt_nexthop = nexthop;
      rt->rt_expire = expire_time;
+     rtable.rt_expire_insert(rt);
 }
 
 void
@@ -510,6 +511,13 @@ double now = CURRENT_TIME;
 double delay = 0.0;
 Packet *p;
 
+ /*
+  * Nothing to do unless a route has expired or packets are waiting
+  * in the send buffer.
+  */
+ if (rqueue.length() == 0 && !rtable.rt_expired(now))
+   return;
+
  for(rt = rtable.head(); rt; rt = rtn) {  // for each rt entry
    rtn = rt->rt_link.le_next;
    if ((rt->rt_flags == RTF_UP) && (rt->rt_expire < now)) {
@@ -715,7 +723,7 @@ rt_update(rt0, rq->rq_src_seqno, rq->rq_hop_count, ih->saddr(),
        rt0->rt_req_cnt = 0;
        rt0->rt_req_timeout = 0.0; 
        rt0->rt_req_last_ttl = rq->rq_hop_count;
-       rt0->rt_expire = CURRENT_TIME + ACTIVE_ROUTE_TIMEOUT;
+       rtable.rt_set_expire(rt0, CURRENT_TIME + ACTIVE_ROUTE_TIMEOUT);
      }
 
      /* Find out whether any buffered packet can benefit from the 
@@ -1019,7 +1027,7 @@ struct hdr_ip *ih = HDR_IP(p);
 
  if (rt) {
    assert(rt->rt_flags == RTF_UP);
-   rt->rt_expire = CURRENT_TIME + ACTIVE_ROUTE_TIMEOUT;
+   rtable.rt_set_expire(rt, CURRENT_TIME + ACTIVE_ROUTE_TIMEOUT);
    ch->next_hop_ = rt->rt_nexthop;
    ch->addr_type() = NS_AF_INET;
    ch->direction() = hdr_cmn::DOWN;       //important: change the packet's direction
@@ -1136,7 +1144,7 @@ aodv_rt_entry *rt = rtable.rt_lookup(dst);
  // Don't let the timeout to be too large, however .. SRD 6/8/99
  if (rt->rt_req_timeout > CURRENT_TIME + MAX_RREQ_TIMEOUT)
    rt->rt_req_timeout = CURRENT_TIME + MAX_RREQ_TIMEOUT;
- rt->rt_expire = 0;
+ rtable.rt_set_expire(rt, 0);
 
 #ifdef DEBUG
  fprintf(stderr, "(%2d) - %2d sending Route Request, dst: %d, tout %f ms\n",
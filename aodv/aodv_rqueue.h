@@ -73,6 +73,8 @@ class aodv_rqueue : public Connector {
    */
         char            find(nsaddr_t dst);
 
+        int             length(void) { return len_; }
+
  private:
         Packet*         remove_head();
         void            purge(void);
@@ -173,12 +173,50 @@ AODV_Precursor *pc;
   The Routing Table
 */
 
+#define RT_HASH(id, n)	(((u_int32_t)(id) ^ ((u_int32_t)(id) >> 11) ^ \
+			  ((u_int32_t)(id) >> 22)) & ((n) - 1))
+
+aodv_rtable::aodv_rtable()
+{
+ LIST_INIT(&rthead);
+ rt_hash = 0;
+ rt_nbucket = rt_count = 0;
+ rt_heap = 0;
+ rt_nheap = rt_maxheap = 0;
+}
+
+aodv_rtable::~aodv_rtable()
+{
+ delete [] rt_hash;
+ delete [] rt_heap;
+}
+
+void
+aodv_rtable::rt_rehash(int nbucket)
+{
+aodv_rt_entry *rt;
+
+ delete [] rt_hash;
+ rt_hash = new aodv_rt_entry*[nbucket];
+ rt_nbucket = nbucket;
+ for (int i = 0; i < nbucket; i++)
+   rt_hash[i] = 0;
+ for(rt = rthead.lh_first; rt; rt = rt->rt_link.le_next) {
+   int h = RT_HASH(rt->rt_dst, rt_nbucket);
+   rt->rt_hnext = rt_hash[h];
+   rt_hash[h] = rt;
+ }
+}
+
 aodv_rt_entry*
 aodv_rtable::rt_lookup(nsaddr_t id)
 {
-aodv_rt_entry *rt = rthead.lh_first;
+aodv_rt_entry *rt;
 
- for(; rt; rt = rt->rt_link.le_next) {
+ if (rt_count == 0)
+   return 0;
+ rt = rt_hash[RT_HASH(id, rt_nbucket)];
+ for(; rt; rt = rt->rt_hnext) {
    if(rt->rt_dst == id)
      break;
  }
@@ -192,6 +230,11 @@ aodv_rtable::rt_delete(nsaddr_t id)
 aodv_rt_entry *rt = rt_lookup(id);
 
  if(rt) {
+   aodv_rt_entry **pp = &rt_hash[RT_HASH(id, rt_nbucket)];
+   while (*pp != rt)
+     pp = &(*pp)->rt_hnext;
+   *pp = rt->rt_hnext;
+   rt_count--;
    LIST_REMOVE(rt, rt_link);
    delete rt;
  }
@@ -208,5 +251,101 @@ aodv_rt_entry *rt;
  assert(rt);
  rt->rt_dst = id;
  LIST_INSERT_HEAD(&rthead, rt, rt_link);
+ if (rt_count >= rt_nbucket)
+   rt_rehash(rt_nbucket ? 2 * rt_nbucket : 64);
+ else {
+   int h = RT_HASH(id, rt_nbucket);
+   rt->rt_hnext = rt_hash[h];
+   rt_hash[h] = rt;
+ }
+ rt_count++;
  return rt;
 }
+
+/*
+  The expiry heap
+*/
+
+void
+aodv_rtable::heap_push(double t, nsaddr_t dst)
+{
+ if (rt_nheap == rt_maxheap) {
+   rt_maxheap = rt_maxheap ? 2 * rt_maxheap : 64;
+   rt_timeout *h = new rt_timeout[rt_maxheap];
+   for (int i = 0; i < rt_nheap; i++)
+     h[i] = rt_heap[i];
+   delete [] rt_heap;
+   rt_heap = h;
+ }
+ int i = rt_nheap++;
+ while (i > 0 && t < rt_heap[(i - 1) / 2].time) {
+   rt_heap[i] = rt_heap[(i - 1) / 2];
+   i = (i - 1) / 2;
+ }
+ rt_heap[i].time = t;
+ rt_heap[i].dst = dst;
+}
+
+void
+aodv_rtable::heap_pop(void)
+{
+ rt_timeout last = rt_heap[--rt_nheap];
+ int i = 0;
+ for (;;) {
+   int c = 2 * i + 1;
+   if (c >= rt_nheap)
+     break;
+   if (c + 1 < rt_nheap && rt_heap[c + 1].time < rt_heap[c].time)
+     c++;
+   if (!(rt_heap[c].time < last.time))
+     break;
+   rt_heap[i] = rt_heap[c];
+   i = c;
+ }
+ rt_heap[i] = last;
+}
+
+/*
+ * Called whenever a route comes up, with its new expiry time.
+ */
+void
+aodv_rtable::rt_expire_insert(aodv_rt_entry *rt)
+{
+ heap_push(rt->rt_expire, rt->rt_dst);
+}
+
+/*
+ * Later expiry times are covered by the route's current heap entry,
+ * only an earlier one needs a new entry.
+ */
+void
+aodv_rtable::rt_set_expire(aodv_rt_entry *rt, double t)
+{
+ if (t < rt->rt_expire)
+   heap_push(t, rt->rt_dst);
+ rt->rt_expire = t;
+}
+
+/*
+ * Is there a route up with rt_expire < now?  Stale entries (routes
+ * that went down, or whose lifetime was extended) are dropped or
+ * moved to the current expiry time on the way.
+ */
+bool
+aodv_rtable::rt_expired(double now)
+{
+aodv_rt_entry *rt;
+
+ while (rt_nheap > 0 && rt_heap[0].time < now) {
+   rt = rt_lookup(rt_heap[0].dst);
+   if (rt && rt->rt_flags == RTF_UP) {
+     if (rt->rt_expire < now)
+       return true;
+     heap_pop();
+     heap_push(rt->rt_expire, rt->rt_dst);
+   }
+   else
+     heap_pop();
+ }
+ return false;
+}
@@ -137,6 +137,8 @@ class aodv_rt_entry {
          * a list of neighbors that are using this route.
          */
         aodv_ncache          rt_nblist;
+
+        aodv_rt_entry   *rt_hnext;      // next entry in hash bucket
 };
 
 
@@ -146,7 +148,8 @@ class aodv_rt_entry {
 
 class aodv_rtable {
  public:
-	aodv_rtable() { LIST_INIT(&rthead); }
+	aodv_rtable();
+	~aodv_rtable();
 
         aodv_rt_entry*       head() { return rthead.lh_first; }
 
@@ -154,8 +157,37 @@ class aodv_rtable {
         void                 rt_delete(nsaddr_t id);
         aodv_rt_entry*       rt_lookup(nsaddr_t id);
 
+        /*
+         * Expiry heap: every route that is up has an entry no later
+         * than its rt_expire, so AODV::rt_purge() can tell whether any
+         * route has expired without walking the table.
+         */
+        void                 rt_expire_insert(aodv_rt_entry *rt);
+        void                 rt_set_expire(aodv_rt_entry *rt, double t);
+        bool                 rt_expired(double now);
+
  private:
+        void                 rt_rehash(int nbucket);
+        void                 heap_push(double t, nsaddr_t dst);
+        void                 heap_pop(void);
+
         LIST_HEAD(aodv_rthead, aodv_rt_entry) rthead;
+
+        /*
+         * Hash index of rthead, chained through rt_hnext.  Flat node
+         * addresses hash to themselves, so with no more nodes than
+         * buckets this is a direct, array indexed lookup.
+         */
+        aodv_rt_entry        **rt_hash;
+        int                  rt_nbucket;
+        int                  rt_count;
+
+        struct rt_timeout {
+                double          time;
+                nsaddr_t        dst;
+        }                    *rt_heap;
+        int                  rt_nheap;
+        int                  rt_maxheap;
 };
 
 #endif /* _aodv__rtable_h__ */
@@ -67,6 +67,13 @@ public:
 	int do_set_hash(nsaddr_t src, nsaddr_t dst, int fid, int slot) {
 		return (set_hash(src,dst,fid,slot));
 	}
+	/* forget the entry, so that the default target is used again */
+	void unset_hash(nsaddr_t src, nsaddr_t dst, int fid) {
+		Tcl_HashEntry *ep= Tcl_FindHashEntry(&ht_,
+						     hashkey(src, dst, fid));
+		if (ep)
+			Tcl_DeleteHashEntry(ep);
+	}
 	void set_table_size(int nn) {}
 protected:
 	union hkey {
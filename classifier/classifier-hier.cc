@@ -48,8 +48,68 @@
 // $Header: /nfs/jade/vint/CVSROOT/ns-2/classifier/classifier-hier.cc,v 1.8 2005/08/25 18:58:01 johnh Exp $
 
 #include <assert.h>
+#include <typeinfo>
 #include "classifier-hier.h"
+#include "classifier-addr.h"
 #include "route.h"
+#include "ip.h"
+
+void HierClassifier::recv(Packet *p, Handler *h)
+{
+	if (cachesize_ > 0) {
+		if (cache_ == 0)
+			alloc_cache();
+		int addr = hdr_ip::access(p)->daddr();
+		HierCacheEntry* e = &cache_[((unsigned)addr * 2654435761U >> 16)
+					    & (ncache_ - 1)];
+		if (e->gen != generation_ || e->addr != addr) {
+			NsObject* target = resolve(addr);
+			if (target == 0) {
+				clsfr_[0]->recv(p, h);
+				return;
+			}
+			e->addr = addr;
+			e->gen = generation_;
+			e->target = target;
+		}
+		e->target->recv(p, h);
+		return;
+	}
+	clsfr_[0]->recv(p, h);
+}
+
+/*
+ * What the chain of classifiers would hand a packet for addr to, or 0
+ * if some level isn't a plain address classifier or would make an
+ * upcall.
+ */
+NsObject* HierClassifier::resolve(int addr)
+{
+	int n = AddrParamsClass::instance().hlevel();
+	for (int i = 0; i < n; i++) {
+		if (!flat_[i])
+			return (0);
+		NsObject* node = clsfr_[i]->slot(clsfr_[i]->mshift(addr));
+		if (node == 0 && (node = clsfr_[i]->default_target()) == 0)
+			return (0);
+		if (i == n - 1 || node != clsfr_[i + 1])
+			return (node);
+	}
+	return (0);
+}
+
+void HierClassifier::alloc_cache()
+{
+	ncache_ = 1;
+	while (ncache_ < cachesize_)
+		ncache_ <<= 1;
+	cache_ = new HierCacheEntry[ncache_];
+	for (int i = 0; i < ncache_; i++) {
+		cache_[i].addr = 0;
+		cache_[i].gen = generation_ - 1;
+		cache_[i].target = 0;
+	}
+}
 
 
 int HierClassifier::command(int argc, const char*const* argv)
@@ -79,6 +139,10 @@ int HierClassifier::command(int argc, const char*const* argv)
 			int n = atoi(argv[2]) - 1;
 			Classifier *c=(Classifier*)TclObject::lookup(argv[3]);
 			clsfr_[n] = c;
+			// subclasses may classify on something else
+			flat_[n] = (c != 0 && 
+				    typeid(*c) == typeid(AddressClassifier));
+			++generation_;
 			return (TCL_OK);
 		}
 	}
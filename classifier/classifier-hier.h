@@ -55,22 +55,47 @@
 #include "addr-params.h"
 #include "route.h"
 
+/*
+ * A packet goes through one Classifier/Addr per address level before
+ * reaching its target.  HierClassifier keeps a small direct-mapped
+ * cache of the final target for each destination address, so that
+ * most packets skip the chain.  The cache is dropped whenever a
+ * classifier changes (Classifier::generation_); lookups that would
+ * make a "no-slot" upcall are never cached.
+ */
+struct HierCacheEntry {
+	int addr;
+	int gen;
+	NsObject* target;
+};
+
 class HierClassifier : public Classifier {
 public:
-	HierClassifier() : Classifier() {
-		clsfr_ = new Classifier*[AddrParamsClass::instance().hlevel()];
+	HierClassifier() : Classifier(), cache_(0), ncache_(0) {
+		int n = AddrParamsClass::instance().hlevel();
+		clsfr_ = new Classifier*[n];
+		flat_ = new bool[n];
+		for (int i = 0; i < n; i++)
+			flat_[i] = false;
+		bind("cachesize_", &cachesize_);
 	}
 	virtual ~HierClassifier() {
 		// Deletion of contents (classifiers) is done in otcl
 		delete []clsfr_;
+		delete []flat_;
+		delete []cache_;
 	}
-	inline virtual void recv(Packet *p, Handler *h) {
-		clsfr_[0]->recv(p, h);
-	}
+	virtual void recv(Packet *p, Handler *h);
 	virtual int command(int argc, const char*const* argv);
 	virtual void do_install(char *dst, NsObject *target);
 	void set_table_size(int level, int csize);
 private:
+	NsObject* resolve(int addr);
+	void alloc_cache();
+
 	Classifier **clsfr_;
+	bool *flat_;		// clsfr_[i] is a plain Classifier/Addr
+	HierCacheEntry *cache_;
+	int ncache_;
+	int cachesize_;		// entries in the cache, 0 to disable
 };
-
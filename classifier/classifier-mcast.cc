@@ -56,40 +56,81 @@ public:
 
 MCastClassifier::MCastClassifier()
 {
-	memset(ht_, 0, sizeof(ht_));
-	memset(ht_star_, 0, sizeof(ht_star_));
+	ht_.size = ht_star_.size = HASHSIZE;
+	ht_.count = ht_star_.count = 0;
+	ht_.bucket = new hashnode*[HASHSIZE];
+	ht_star_.bucket = new hashnode*[HASHSIZE];
+	memset(ht_.bucket, 0, HASHSIZE * sizeof(hashnode*));
+	memset(ht_star_.bucket, 0, HASHSIZE * sizeof(hashnode*));
 }
 
 MCastClassifier::~MCastClassifier()
 {
 	clearAll();
+	delete [] ht_.bucket;
+	delete [] ht_star_.bucket;
 }
 
-void MCastClassifier::clearHash(hashnode* h[], int size) 
+void MCastClassifier::clearHash(hashtable& ht) 
 {
-	for (int i = 0; i < size; ++i) {
-		hashnode* p = h[i];
+	for (int i = 0; i < ht.size; ++i) {
+		hashnode* p = ht.bucket[i];
 		while (p != 0) {
 			hashnode* n = p->next;
 			delete p;
 			p = n;
 		}
 	}
-	memset(h, 0, size * sizeof(hashnode*));
+	memset(ht.bucket, 0, ht.size * sizeof(hashnode*));
+	ht.count = 0;
 }
 
 void MCastClassifier::clearAll()
 {
-	clearHash(ht_, HASHSIZE);
-	clearHash(ht_star_, HASHSIZE);
+	clearHash(ht_);
+	clearHash(ht_star_);
+}
+
+/*
+ * Double the number of buckets.  Entries with the same <s,g> always
+ * share a chain, and chains are moved in order, so lookups keep
+ * returning the most recently installed matching entry.
+ */
+void MCastClassifier::grow(hashtable& ht)
+{
+	int size = 2 * ht.size;
+	hashnode** bucket = new hashnode*[size];
+	hashnode** tail = new hashnode*[size];
+	for (int i = 0; i < size; ++i) {
+		bucket[i] = 0;
+		tail[i] = 0;
+	}
+	for (int i = 0; i < ht.size; ++i) {
+		hashnode* p = ht.bucket[i];
+		while (p != 0) {
+			hashnode* n = p->next;
+			int h = hash(p->src, p->dst, size);
+			p->next = 0;
+			if (tail[h] == 0)
+				bucket[h] = p;
+			else
+				tail[h]->next = p;
+			tail[h] = p;
+			p = n;
+		}
+	}
+	delete [] tail;
+	delete [] ht.bucket;
+	ht.bucket = bucket;
+	ht.size = size;
 }
 
 MCastClassifier::hashnode*
 MCastClassifier::lookup(nsaddr_t src, nsaddr_t dst, int iface) const
 {
-	int h = hash(src, dst);
+	int h = hash(src, dst, ht_.size);
 	hashnode* p;
-	for (p = ht_[h]; p != 0; p = p->next) {
+	for (p = ht_.bucket[h]; p != 0; p = p->next) {
 		if (p->src == src && p->dst == dst)
  			if (p->iif == iface ||
  			    //p->iif == UNKN_IFACE.value() ||
@@ -102,9 +143,9 @@ MCastClassifier::lookup(nsaddr_t src, nsaddr_t dst, int iface) const
 MCastClassifier::hashnode*
 MCastClassifier::lookup_star(nsaddr_t dst, int iface) const
 {
-	int h = hash(0, dst);
+	int h = hash(0, dst, ht_star_.size);
 	hashnode* p;
-	for (p = ht_star_[h]; p != 0; p = p->next) {
+	for (p = ht_star_.bucket[h]; p != 0; p = p->next) {
 		if (p->dst == dst && 
 		    (iface == ANY_IFACE.value() || p->iif == iface))
   		       break;
@@ -163,17 +204,20 @@ int MCastClassifier::findslot()
 	return (i);
 }
 
-void MCastClassifier::set_hash(hashnode* ht[], nsaddr_t src, nsaddr_t dst,
+void MCastClassifier::set_hash(hashtable& ht, nsaddr_t src, nsaddr_t dst,
 			       int slot, int iface)
 {
-	int h = hash(src, dst);
+	if (ht.count >= 2 * ht.size)
+		grow(ht);
+	int h = hash(src, dst, ht.size);
 	hashnode* p = new hashnode;
 	p->src = src;
 	p->dst = dst;
 	p->slot = slot;
 	p->iif = iface;
-	p->next = ht[h];
-	ht[h] = p;
+	p->next = ht.bucket[h];
+	ht.bucket[h] = p;
+	++ht.count;
 }
 
 int MCastClassifier::command(int argc, const char*const* argv)
@@ -62,7 +62,7 @@ protected:
 	virtual int command(int argc, const char*const* argv);
 	virtual int classify(Packet *p);
 	int findslot();
-	enum {HASHSIZE = 256};
+	enum {HASHSIZE = 256};	// initial number of buckets
 	struct hashnode {
 		int slot;
 		nsaddr_t src;
@@ -70,19 +70,32 @@ protected:
 		hashnode* next;
 		int iif; // for RPF checking
 	};
-	int hash(nsaddr_t src, nsaddr_t dst) const {
-		u_int32_t s = src ^ dst;
+	/*
+	 * Chained hash table that doubles its number of buckets
+	 * whenever it holds more than two entries per bucket, so that
+	 * routers on trees with many sources and groups keep short
+	 * chains.
+	 */
+	struct hashtable {
+		hashnode** bucket;
+		int size;		// a power of 2
+		int count;
+	};
+	static int hash(nsaddr_t src, nsaddr_t dst, int size) {
+		u_int32_t s = (u_int32_t)src * 0x9e3779b1U ^ (u_int32_t)dst;
 		s ^= s >> 16;
-		s ^= s >> 8;
-		return (s & 0xff);
+		s *= 0x85ebca6bU;
+		s ^= s >> 13;
+		return (s & (size - 1));
 	}
-	hashnode* ht_[HASHSIZE];
-	hashnode* ht_star_[HASHSIZE]; // for search by group only (not <s,g>)
+	hashtable ht_;
+	hashtable ht_star_; // for search by group only (not <s,g>)
 
-	void set_hash(hashnode* ht[], nsaddr_t src, nsaddr_t dst,
+	void set_hash(hashtable& ht, nsaddr_t src, nsaddr_t dst,
 		      int slot, int iface);
+	void grow(hashtable& ht);
 	void clearAll();
-	void clearHash(hashnode* h[], int size);
+	void clearHash(hashtable& ht);
 	hashnode* lookup(nsaddr_t src, nsaddr_t dst,
 			 int iface = iface_literal::ANY_IFACE) const;
 	hashnode* lookup_star(nsaddr_t dst,
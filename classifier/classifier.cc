@@ -51,6 +51,8 @@ public:
 } class_classifier;
 
 
+int Classifier::generation_;
+
 Classifier::Classifier() : 
 	slot_(0), nslot_(0), maxslot_(-1), shift_(0), mask_(0xffffffff), nsize_(0)
 {
@@ -106,11 +108,13 @@ void Classifier::install(int slot, NsObject* p)
 	slot_[slot] = p;
 	if (slot >= maxslot_)
 		maxslot_ = slot;
+	++generation_;
 }
 
 void Classifier::clear(int slot)
 {
 	slot_[slot] = 0;
+	++generation_;
 	if (slot == maxslot_) {
 		while (--maxslot_ >= 0 && slot_[maxslot_] == 0)
 			;
@@ -269,6 +273,7 @@ int Classifier::command(int argc, const char*const* argv)
 		}
 		if (strcmp(argv[1], "defaulttarget") == 0) {
 			default_target_=(NsObject*)TclObject::lookup(argv[2]);
+			++generation_;
 			if (default_target_ == 0)
 				return TCL_ERROR;
 			return TCL_OK;
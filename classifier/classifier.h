@@ -55,7 +55,12 @@ public:
 	inline int mshift(int val) { return ((val >> shift_) & mask_); }
 	inline void set_default_target(NsObject *obj) { 
 		default_target_ = obj;
+		++generation_;
 	}
+	inline NsObject* default_target() { return default_target_; }
+	// bumped whenever a slot or default target changes, so that
+	// caches of lookups can tell they are stale
+	static int generation_;
 
 	virtual void recv(Packet* p, Handler* h);
 	virtual NsObject* find(Packet*);
@@ -115,10 +115,14 @@ PositionHandler::handle(Event*)
    Mobile Node
    ====================================================================== */
 
+unsigned int MobileNode::moved_ = 0;
+int MobileNode::moving_ = 0;
+
 MobileNode::MobileNode(void) : 
 	pos_handle_(this)
 {
 	X_ = Y_ = Z_ = speed_ = 0.0;
+	inmotion_ = 0;
 	dX_ = dY_ = dZ_ = 0.0;
 	destX_ = destY_ = 0.0;
 
@@ -160,6 +164,9 @@ MobileNode::command(int argc, const char*const* argv)
 		        update_position();
 		        log_movement();
 			return TCL_OK;
+		} else if(strcmp(argv[1], "position-changed") == 0) {
+			position_changed();
+			return TCL_OK;
 		} else if(strcmp(argv[1], "log-energy") == 0) {
 			log_energy(1);
 			return TCL_OK;
@@ -431,6 +438,7 @@ MobileNode::set_destination(double x, double y, double s)
 	}
   
 	position_update_time_ = Scheduler::instance().clock();
+	motion_update();
 
 #ifdef DEBUG
 	fprintf(stderr, "%d - %s: calling log_movement()\n", 
@@ -467,7 +475,7 @@ MobileNode::update_position()
 	double now = Scheduler::instance().clock();
 	double interval = now - position_update_time_;
 	double oldX = X_;
-	//double oldY = Y_;
+	double oldY = Y_;
 
 	if ((interval == 0.0)&&(position_update_time_!=0))
 		return;         // ^^^ for list-based imprvmnt 
@@ -494,6 +502,21 @@ MobileNode::update_position()
 		address_, X_, Y_, Z_, now);
 #endif
 	position_update_time_ = now;
+	if (X_ != oldX || Y_ != oldY)
+		position_changed();
+	motion_update();
+}
+
+/* keep moving_ up to date once speed_ or the destination changed */
+void
+MobileNode::motion_update()
+{
+	int m = (speed_ != 0.0 && (X_ != destX_ || Y_ != destY_));
+
+	if (m != inmotion_) {
+		inmotion_ = m;
+		moving_ += m ? 1 : -1;
+	}
 }
 
 
@@ -510,6 +533,7 @@ MobileNode::random_position()
 	Z_ = T_->height(X_, Y_);
 
 	position_update_time_ = 0.0;
+	position_changed();
 }
 
 void
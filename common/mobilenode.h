@@ -154,6 +154,17 @@ public:
 	//inline double last_routingtime() { return last_rt_time_;}
 
 	void update_position();
+
+	/*
+	 * For the neighbor cache of WirelessChannel: moved() changes
+	 * whenever the position of any node is updated or set, from C++
+	 * or through X_, Y_ or Z_ in Tcl (see ns-mobilenode.tcl), and
+	 * moving() is the number of nodes on their way to a destination.
+	 */
+	void position_changed() { moved_++; }
+	static unsigned int moved() { return moved_; }
+	static int moving() { return moving_; }
+
 	void log_energy(int);
 	//void logrttime(double);
 	virtual void idle_energy_patch(float, float);
@@ -201,6 +212,12 @@ protected:
 	PositionHandler pos_handle_;
 	Event pos_intr_;
 
+	/* see moved() */
+	int inmotion_;
+	static unsigned int moved_;
+	static int moving_;
+	void	motion_update();
+
 	void	log_movement();
 	void	random_direction();
 	void	random_speed();
@@ -97,13 +97,20 @@ enum AppDataType {
 class AppData {
 private:
 	AppDataType type_;  	// ADU type
+	int refs_;		// number of extra packets sharing this ADU
 public:
-	AppData(AppDataType type) { type_ = type; }
-	AppData(AppData& d) { type_ = d.type_; }
+	AppData(AppDataType type) { type_ = type; refs_ = 0; }
+	AppData(AppData& d) { type_ = d.type_; refs_ = 0; }
 	virtual ~AppData() {}
 
 	AppDataType type() const { return type_; }
 
+	// Sharing of one ADU by the copies of a packet, see
+	// Packet::copy_shared()
+	int shared() const { return refs_; }
+	void ref() { ++refs_; }
+	void unref() { --refs_; }
+
 	// The following two methods MUST be rewrited for EVERY derived classes
 	virtual int size() const { return sizeof(AppData); }
 	virtual AppData* copy() = 0;
@@ -340,8 +340,11 @@ private:
 	unsigned char* bits_;	// header bits
 //	unsigned char* data_;	// variable size buffer for 'data'
 //  	unsigned int datalen_;	// length of variable size buffer
-	AppData* data_;		// variable size buffer for 'data'
+	mutable AppData* data_;	// variable size buffer for 'data'
 	static void init(Packet*);     // initialize pkt hdr 
+	static inline Packet* get();
+	static inline void freedata(AppData*);
+	inline void unshare() const;
 	bool fflag_;
 protected:
 	static Packet* free_;	// packet free list
@@ -353,6 +356,7 @@ public:
 	Packet() : bits_(0), data_(0), ref_count_(0), next_(0) { }
 	inline unsigned char* const bits() { return (bits_); }
 	inline Packet* copy() const;
+	inline Packet* copy_shared() const;
 	inline Packet* refcopy() { ++ref_count_; return this; }
 	inline int& ref_count() { return (ref_count_); }
 	static inline Packet* alloc();
@@ -371,17 +375,19 @@ public:
 	inline unsigned char* accessdata() const { 
 		if (data_ == 0)
 			return 0;
+		unshare();
 		assert(data_->type() == PACKET_DATA);
 		return (((PacketData*)data_)->data()); 
 	}
 	// This is used to access application-specific data, not limited 
 	// to PacketData.
 	inline AppData* userdata() const {
+		unshare();
 		return data_;
 	}
 	inline void setdata(AppData* d) { 
 		if (data_ != NULL)
-			delete data_;
+			freedata(data_);
 		data_ = d; 
 	}
 	inline int datalen() const { return data_ ? data_->size() : 0; }
@@ -537,7 +543,11 @@ inline void Packet::init(Packet* p)
 	bzero(p->bits_, hdrlen_);
 }
 
-inline Packet* Packet::alloc()
+/*
+ * Take a packet off the free list (or make a new one); its header
+ * bits are left for the caller to fill in.
+ */
+inline Packet* Packet::get()
 {
 	Packet* p = free_;
 	if (p != 0) {
@@ -552,14 +562,20 @@ inline Packet* Packet::alloc()
 		if (p == 0 || p->bits_ == 0)
 			abort();
 	}
+	p->fflag_ = TRUE;
+	p->next_ = 0;
+	return (p);
+}
+
+inline Packet* Packet::alloc()
+{
+	Packet* p = get();
 	init(p); // Initialize bits_[]
 	(HDR_CMN(p))->next_hop_ = -2; // -1 reserved for IP_BROADCAST
 	(HDR_CMN(p))->last_hop_ = -2; // -1 reserved for IP_BROADCAST
-	p->fflag_ = TRUE;
 	(HDR_CMN(p))->direction() = hdr_cmn::DOWN;
 	/* setting all direction of pkts to be downward as default; 
 	   until channel changes it to +1 (upward) */
-	p->next_ = 0;
 	return (p);
 }
 
@@ -597,7 +613,7 @@ inline void Packet::free(Packet* p)
 			assert(p->uid_ <= 0);
 			// Delete user data because we won't need it any more.
 			if (p->data_ != 0) {
-				delete p->data_;
+				freedata(p->data_);
 				p->data_ = 0;
 			}
 			init(p);
@@ -613,7 +629,7 @@ inline void Packet::free(Packet* p)
 inline Packet* Packet::copy() const
 {
 	
-	Packet* p = alloc();
+	Packet* p = get();
 	memcpy(p->bits(), bits_, hdrlen_);
 	if (data_) 
 		p->data_ = data_->copy();
@@ -622,6 +638,45 @@ inline Packet* Packet::copy() const
 	return (p);
 }
 
+/*
+ * Like copy(), but the user data is shared with this packet rather
+ * than duplicated.  Whichever packet first asks for the data through
+ * accessdata() or userdata() while it is still shared gets a private
+ * copy of it, so a fan-out whose copies mostly die in the network
+ * (pruned, dropped or delivered to agents that only look at the
+ * headers) copies the payload at most once per receiver that uses it.
+ */
+inline Packet* Packet::copy_shared() const
+{
+	Packet* p = get();
+	memcpy(p->bits(), bits_, hdrlen_);
+	if (data_) {
+		data_->ref();
+		p->data_ = data_;
+	}
+	p->txinfo_.init(&txinfo_);
+	return (p);
+}
+
+/* Drop a packet's reference to its user data. */
+inline void Packet::freedata(AppData* d)
+{
+	if (d->shared())
+		d->unref();
+	else
+		delete d;
+}
+
+/* Give the packet its own copy of shared user data. */
+inline void Packet::unshare() const
+{
+	if (data_ != 0 && data_->shared()) {
+		AppData* d = data_->copy();
+		data_->unref();
+		data_ = d;
+	}
+}
+
 inline void
 Packet::dump_header(Packet *p, int offset, int length)
 {
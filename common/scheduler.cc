@@ -962,6 +962,7 @@ protected:
 	void sync() { clock_ = tod(); }
 	double tod();
 	double slop_;	// allowed drift between real-time and virt time
+	double minwait_; // don't block for less than this; spin instead
 	double start_;	// starting time
 };
 
@@ -976,6 +977,7 @@ public:
 RealTimeScheduler::RealTimeScheduler() : start_(0.0)
 {
 	bind("maxslop_", &slop_);
+	bind_time("minwait_", &minwait_);
 }
 
 double
@@ -998,7 +1000,6 @@ RealTimeScheduler::reset()
 void 
 RealTimeScheduler::run()
 { 
-	static const double RTSCHEDULER_MINWAIT = 1.0e-3; // don't wait for less
 	const Event *p;
 
 	/*XXX*/
@@ -1030,7 +1031,7 @@ RealTimeScheduler::run()
 		} else {
 			double diff = p->time_ - clock_;
 			// blocking wait only if there is enough time
-			if (diff > RTSCHEDULER_MINWAIT) {
+			if (diff > minwait_) {
 				Tcl_Time to;
 				to.sec = long(diff);
 				to.usec = long(1e6*(diff - to.sec));
@@ -48,6 +48,19 @@
 #include "node.h"
 #include "address.h"
 #include "object.h"
+#include "ip.h"
+#include "rng.h"
+#ifndef WIN32
+#include <errno.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+#ifdef HAVE_STL
+#include "nix/nixnode.h"
+#endif //HAVE_STL
 
 //class ParentNode;
 
@@ -92,8 +105,96 @@ int Simulator::command(int argc, const char*const* argv) {
 			strcpy(macType_, argv[2]);
 			return TCL_OK;
 		}
+#ifdef HAVE_STL
+		if (strcmp(argv[1], "nix-tree-cache") == 0) {
+			NixNode::SetTreeCache(atoi(argv[2]));
+			return TCL_OK;
+		}
+#endif
+	}
+#ifdef HAVE_STL
+	/*
+	 * $ns nix-precompute <threads> <src> <dst> ?<src> <dst> ...?
+	 * Compute the nix-vectors of the given flows now rather than on
+	 * their first packet.
+	 */
+	if (argc >= 3 && strcmp(argv[1], "nix-precompute") == 0) {
+		if (argc % 2 != 1) {
+			tcl.add_errorf("nix-precompute: odd number of node ids");
+			return TCL_ERROR;
+		}
+		int n = (argc - 3) / 2;
+		nodeid_t* src = new nodeid_t[n];
+		nodeid_t* dst = new nodeid_t[n];
+		for (int i = 0; i < n; i++) {
+			src[i] = atol(argv[3 + 2 * i]);
+			dst[i] = atol(argv[4 + 2 * i]);
+		}
+		NixNode::Precompute(n, src, dst, atoi(argv[2]));
+		delete [] src;
+		delete [] dst;
+		return TCL_OK;
+	}
+#endif
+	/*
+	 * $ns checkpoint <path>
+	 * Park the simulation at path.  Returns, in a child branched off
+	 * for each restore, the script sent by that restore, or "" once
+	 * the checkpoint is stopped.
+	 */
+	if (argc == 3 && strcmp(argv[1], "checkpoint") == 0) {
+		char *script = NULL;
+		if (checkpoint(argv[2], &script) < 0) {
+			tcl.add_errorf("checkpoint: cannot listen on %s",
+				       argv[2]);
+			return TCL_ERROR;
+		}
+		if (script != NULL) {
+			tcl.result(script);
+			delete [] script;
+		}
+		return TCL_OK;
 	}
 	if (argc == 4) {
+		/*
+		 * $ns replicate <n> <jobs>
+		 * Fork n replications of the simulation as set up so far,
+		 * at most jobs at a time.  Returns the replication number
+		 * (0 .. n-1) in each child and, in the parent once all of
+		 * them are done, -1 minus the number that failed.
+		 */
+		if (strcmp(argv[1], "replicate") == 0) {
+			int n = atoi(argv[2]);
+			int jobs = atoi(argv[3]);
+			if (n < 1 || jobs < 1) {
+				tcl.add_errorf("replicate: bad count %s %s",
+					       argv[2], argv[3]);
+				return TCL_ERROR;
+			}
+			int r = replicate(n, jobs);
+			if (r == -2) {
+				tcl.add_errorf("replicate: fork failed");
+				return TCL_ERROR;
+			}
+			tcl.resultf("%d", r);
+			return TCL_OK;
+		}
+		/*
+		 * $ns restore <path> <script>
+		 * Branch a variant off the checkpoint at path, wait for
+		 * it to finish and return its exit status; an empty
+		 * script stops the checkpoint.
+		 */
+		if (strcmp(argv[1], "restore") == 0) {
+			int r = restore(argv[2], argv[3]);
+			if (r < 0) {
+				tcl.add_errorf("restore: no checkpoint at %s",
+					       argv[2]);
+				return TCL_ERROR;
+			}
+			tcl.resultf("%d", r);
+			return TCL_OK;
+		}
 		if (strcmp(argv[1], "add-node") == 0) {
 			Node *node = (Node *)(TclObject::lookup(argv[2]));
 			if (node == NULL) {
@@ -135,6 +236,278 @@ int Simulator::command(int argc, const char*const* argv) {
 	return (TclObject::command(argc, argv));
 }
 
+/*
+ * Run n replications of the simulation in forked children, which share
+ * the topology and all the other state built so far copy-on-write.
+ * Every RNG of replication i is moved i substreams ahead, so the
+ * replications draw independent numbers, and replication 0 draws the
+ * same numbers as an ordinary run.  Returns i in the child running
+ * replication i; in the parent returns -1 - (number of replications
+ * that exited non-zero or on a signal), or -2 if fork() failed.
+ */
+int Simulator::replicate(int n, int jobs)
+{
+#ifdef WIN32
+	return (n == 1 ? 0 : -2);
+#else
+	int running = 0, failed = 0, status;
+	fflush(NULL);
+	for (int i = 0; i < n; i++) {
+		if (running == jobs) {
+			if (wait(&status) > 0 &&
+			    (!WIFEXITED(status) || WEXITSTATUS(status) != 0))
+				failed++;
+			running--;
+		}
+		pid_t pid = fork();
+		if (pid < 0) {
+			while (running-- > 0)
+				wait(&status);
+			return (-2);
+		}
+		if (pid == 0) {
+			RNG::next_substream_all(i);
+			return (i);
+		}
+		running++;
+	}
+	while (running > 0) {
+		if (wait(&status) < 0)
+			break;
+		if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+			failed++;
+		running--;
+	}
+	if (failed > 0)
+		fprintf(stderr, "replicate: %d of %d replications failed\n",
+			failed, n);
+	return (-1 - failed);
+#endif
+}
+
+#ifndef WIN32
+static int checkpoint_socket(const char *path, struct sockaddr_un *sa)
+{
+	if (strlen(path) >= sizeof(sa->sun_path))
+		return (-1);
+	memset(sa, 0, sizeof(*sa));
+	sa->sun_family = AF_UNIX;
+	strcpy(sa->sun_path, path);
+	return (socket(AF_UNIX, SOCK_STREAM, 0));
+}
+
+static int write_all(int fd, const char *buf, int len)
+{
+	while (len > 0) {
+		int k = write(fd, buf, len);
+		if (k < 0) {
+			if (errno == EINTR)
+				continue;
+			return (-1);
+		}
+		buf += k;
+		len -= k;
+	}
+	return (0);
+}
+
+static int read_all(int fd, char *buf, int len)
+{
+	while (len > 0) {
+		int k = read(fd, buf, len);
+		if (k < 0 && errno == EINTR)
+			continue;
+		if (k <= 0)
+			return (-1);
+		buf += k;
+		len -= k;
+	}
+	return (0);
+}
+
+/*
+ * A restore sends the length of its script together with its stdin,
+ * stdout and stderr (SCM_RIGHTS), then the script, as a client of the
+ * zygote does (see zygote.cc).  Returns the length, with the
+ * descriptors in fds and the nul-terminated script in *script, or -1.
+ */
+static int recv_script(int c, int *fds, char **script)
+{
+	int len;
+	char ctl[CMSG_SPACE(3 * sizeof(int))];
+	struct iovec iov;
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	iov.iov_base = (char *)&len;
+	iov.iov_len = sizeof(len);
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = ctl;
+	msg.msg_controllen = sizeof(ctl);
+	struct cmsghdr *cm;
+	if (recvmsg(c, &msg, 0) != sizeof(len) ||
+	    (cm = CMSG_FIRSTHDR(&msg)) == NULL ||
+	    cm->cmsg_type != SCM_RIGHTS ||
+	    cm->cmsg_len != CMSG_LEN(3 * sizeof(int)))
+		return (-1);
+	memcpy(fds, CMSG_DATA(cm), 3 * sizeof(int));
+	char *buf = (len >= 0) ? new char[len + 1] : NULL;
+	if (buf == NULL || read_all(c, buf, len) < 0) {
+		delete [] buf;
+		for (int i = 0; i < 3; i++)
+			close(fds[i]);
+		return (-1);
+	}
+	buf[len] = 0;
+	*script = buf;
+	return (len);
+}
+#endif
+
+/*
+ * Park the simulation, with its scheduler queue, packets in flight,
+ * timers and RNG states, at a Unix socket.  For each restore()
+ * connecting to path a waiter is forked, which forks a variant off
+ * this exact state and sends the restore the variant's wait() status
+ * once it is done.  The variant returns 1 with *script set to the
+ * (Tcl) script sent by the client, typically parameter changes for one
+ * variant, and with the client's stdin, stdout and stderr in place of
+ * its own.  Files opened before the checkpoint, traces included, are
+ * shared by all the variants, file offsets and all.  An empty script
+ * stops the checkpoint, which then waits for the remaining variants
+ * and returns 0.  Returns -1 if path cannot be listened on.
+ */
+int Simulator::checkpoint(const char *path, char **script)
+{
+#ifdef WIN32
+	return (-1);
+#else
+	struct sockaddr_un sa;
+	int s = checkpoint_socket(path, &sa);
+	if (s < 0)
+		return (-1);
+	/* Remove a stale checkpoint socket, but never a regular file. */
+	struct stat st;
+	if (lstat(path, &st) == 0 && S_ISSOCK(st.st_mode))
+		unlink(path);
+	if (::bind(s, (struct sockaddr *)&sa, sizeof(sa)) < 0 ||
+	    listen(s, 8) < 0) {
+		close(s);
+		return (-1);
+	}
+	fflush(NULL);
+	for (;;) {
+		int c = accept(s, NULL, NULL);
+		if (c < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		int i, fds[3];
+		char *buf;
+		int len = recv_script(c, fds, &buf);
+		if (len < 0) {
+			close(c);
+			continue;
+		}
+		if (len == 0) {
+			int status = 0;
+			for (i = 0; i < 3; i++)
+				close(fds[i]);
+			write_all(c, (char *)&status, sizeof(status));
+			delete [] buf;
+			close(c);
+			break;
+		}
+		if (fork() == 0) {
+			close(s);
+			pid_t pid = fork();
+			if (pid == 0) {
+				close(c);
+				for (i = 0; i < 3; i++) {
+					dup2(fds[i], i);
+					if (fds[i] > 2)
+						close(fds[i]);
+				}
+				*script = buf;
+				return (1);
+			}
+			int status = 1 << 8;
+			for (i = 0; i < 3; i++)
+				close(fds[i]);
+			while (pid > 0 && waitpid(pid, &status, 0) < 0 &&
+			       errno == EINTR)
+				;
+			write_all(c, (char *)&status, sizeof(status));
+			_exit(0);
+		}
+		for (i = 0; i < 3; i++)
+			close(fds[i]);
+		delete [] buf;
+		close(c);
+		while (waitpid(-1, NULL, WNOHANG) > 0)
+			;
+	}
+	close(s);
+	unlink(path);
+	while (wait(NULL) > 0 || errno == EINTR)
+		;
+	return (0);
+#endif
+}
+
+/*
+ * Send script, and our stdin, stdout and stderr, to the checkpoint at
+ * path and wait until the variant it started has finished.  Returns
+ * the variant's exit status (1 if it was killed), or -1 if there is no
+ * checkpoint at path.
+ */
+int Simulator::restore(const char *path, const char *script)
+{
+#ifdef WIN32
+	return (-1);
+#else
+	struct sockaddr_un sa;
+	int s = checkpoint_socket(path, &sa);
+	if (s < 0)
+		return (-1);
+	if (connect(s, (struct sockaddr *)&sa, sizeof(sa)) < 0) {
+		close(s);
+		return (-1);
+	}
+	fflush(NULL);
+	int len = strlen(script);
+	int fds[3] = { 0, 1, 2 };
+	char ctl[CMSG_SPACE(sizeof(fds))];
+	struct iovec iov;
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	iov.iov_base = (char *)&len;
+	iov.iov_len = sizeof(len);
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = ctl;
+	msg.msg_controllen = sizeof(ctl);
+	struct cmsghdr *cm = CMSG_FIRSTHDR(&msg);
+	cm->cmsg_level = SOL_SOCKET;
+	cm->cmsg_type = SCM_RIGHTS;
+	cm->cmsg_len = CMSG_LEN(sizeof(fds));
+	memcpy(CMSG_DATA(cm), fds, sizeof(fds));
+	if (sendmsg(s, &msg, 0) != sizeof(len)) {
+		close(s);
+		return (-1);
+	}
+	int status;
+	if (write_all(s, script, len) < 0 ||
+	    read_all(s, (char *)&status, sizeof(status)) < 0) {
+		fprintf(stderr, "restore: lost the checkpoint at %s\n", path);
+		status = 1 << 8;
+	}
+	close(s);
+	return (WIFEXITED(status) ? WEXITSTATUS(status) : 1);
+#endif
+}
+
 void Simulator::add_node(ParentNode *node, int id) {
 	if (nodelist_ == NULL) 
 		nodelist_ = new ParentNode*[SMALL_LEN]; 
@@ -280,6 +653,22 @@ char *Simulator::append_addr(int level, int *addr) {
 }
 
 
+// Install the route from node to dst on demand, see LazyRoute.
+NsObject* Simulator::lazy_route(ParentNode *node, int dst) {
+	char tmp[SMALL_LEN];
+	if (rtobject_ == NULL)
+		return NULL;
+	int nh = rtobject_->lookup_flat(node->nodeid(), dst);
+	if (nh < 0)
+		return NULL;
+	NsObject *l_head = get_link_head(node, nh);
+	if (l_head == NULL)
+		return NULL;
+	sprintf(tmp, "%d", dst);
+	node->add_route(tmp, l_head);
+	return l_head;
+}
+
 NsObject* Simulator::get_link_head(ParentNode *node, int nh) {
 	Tcl& tcl = Tcl::instance();
 	tcl.evalf("[Simulator instance] get-link-head %d %d",
@@ -288,3 +677,66 @@ NsObject* Simulator::get_link_head(ParentNode *node, int nh) {
 	return l_head;
 }
 
+
+static class LazyRouteClass : public TclClass {
+public:
+	LazyRouteClass() : TclClass("LazyRoute") {}
+	TclObject* create(int, const char*const*) {
+		return (new LazyRoute);
+	}
+} class_lazy_route;
+
+int LazyRoute::command(int argc, const char*const* argv) {
+	Tcl& tcl = Tcl::instance();
+	if (argc == 2) {
+		// $lazyroute flush
+		if (strcmp(argv[1], "flush") == 0) {
+			flush();
+			return TCL_OK;
+		}
+	} else if (argc == 4) {
+		// $lazyroute attach $node $classifier
+		if (strcmp(argv[1], "attach") == 0) {
+			node_ = (ParentNode *)(TclObject::lookup(argv[2]));
+			if (node_ == NULL) {
+				tcl.add_errorf("Wrong object name %s", argv[2]);
+				return TCL_ERROR;
+			}
+			cls_ = (HashClassifier *)(TclObject::lookup(argv[3]));
+			if (cls_ == NULL) {
+				tcl.add_errorf("Wrong object name %s", argv[3]);
+				return TCL_ERROR;
+			}
+			return TCL_OK;
+		}
+	}
+	return (NsObject::command(argc, argv));
+}
+
+// Remove the routes installed so far; the next packet to each of
+// these destinations comes back here and looks up its new route.
+void LazyRoute::flush() {
+	for (int i = 0; i < ndst_; i++)
+		cls_->unset_hash(0, dst_[i], 0);
+	ndst_ = 0;
+}
+
+void LazyRoute::recv(Packet *p, Handler *h) {
+	int dst = Address::instance().get_nodeaddr(hdr_ip::access(p)->daddr());
+	NsObject *l_head = Simulator::instance().lazy_route(node_, dst);
+	if (l_head == NULL) {
+		// no route, dropped as by Classifier::recv()
+		Packet::free(p);
+		return;
+	}
+	if (ndst_ == maxdst_) {
+		maxdst_ = maxdst_ ? 2 * maxdst_ : 16;
+		int *d = new int[maxdst_];
+		if (ndst_ > 0)
+			memcpy(d, dst_, ndst_ * sizeof(int));
+		delete [] dst_;
+		dst_ = d;
+	}
+	dst_[ndst_++] = dst;
+	l_head->recv(p, h);
+}
@@ -75,6 +75,10 @@ public:
 	char *append_addr(int level, int *addr);
 	void alloc(int n);
 	void check(int n);
+	NsObject* lazy_route(ParentNode *node, int dst);
+	int replicate(int n, int jobs);
+	int checkpoint(const char *path, char **script);
+	int restore(const char *path, const char *script);
 	
 private:
         ParentNode **nodelist_;
@@ -85,4 +89,29 @@ private:
 	static Simulator* instance_;
 };
 
+class HashClassifier;
+
+/*
+ * Default target of a node's classifier when routes are computed lazily
+ * (RouteLogic lazy_): the first packet for a destination looks up the
+ * route and installs it in the classifier.  The destinations installed
+ * are kept so that flush() can remove them when the routes are
+ * recomputed.
+ */
+class LazyRoute : public NsObject {
+public:
+	LazyRoute() : node_(NULL), cls_(NULL), dst_(NULL), ndst_(0),
+		      maxdst_(0) {}
+	~LazyRoute() { delete [] dst_; }
+	void recv(Packet *p, Handler *h);
+	int command(int argc, const char*const* argv);
+	void flush();
+private:
+	ParentNode *node_;
+	HashClassifier *cls_;	// the node's classifier
+	int *dst_;		// destinations installed since the last flush
+	int ndst_;
+	int maxdst_;
+};
+
 #endif /* ns_simulator_h */
@@ -15,6 +15,7 @@
  */
 
 #include "config.h"
+#include "zygote.h"
 
 extern void init_misc(void);
 extern EmbeddedTcl et_ns_lib;
@@ -29,6 +30,8 @@ MemTrace *globalMemTrace;
 #define NS_BEGIN_EXTERN_C	extern "C" {
 #define NS_END_EXTERN_C		}
 
+static const char *zygote_path = NULL;
+
 NS_BEGIN_EXTERN_C
 
 #ifdef HAVE_FENV_H
@@ -58,12 +61,26 @@ EXTERN int		Tcltest_Init _ANSI_ARGS_((Tcl_Interp *interp));
  * Side effects:
  *	Whatever the application does.
  *
+ *	"ns -zygote <path>" starts a fork server for fast startup, and
+ *	with NS_ZYGOTE set to its path, "ns script ..." runs the script
+ *	in a copy of it (see zygote.h).
+ *
  *----------------------------------------------------------------------
  */
 
 int
 main(int argc, char **argv)
 {
+    const char *zygote = getenv("NS_ZYGOTE");
+    if (zygote != NULL && argc >= 2 && argv[1][0] != '-') {
+	    int status = zygote_attach(zygote, argc - 1, argv + 1);
+	    if (status >= 0)
+		    return status;
+    }
+    if (argc == 3 && strcmp(argv[1], "-zygote") == 0) {
+	    zygote_path = argv[2];
+	    argc = 1;
+    }
     Tcl_Main(argc, argv, Tcl_AppInit);
     return 0;			/* Needed only to prevent compiler warning. */
 }
@@ -269,6 +286,8 @@ Tcl_AppInit(Tcl_Interp *interp)
 			  (Tcl_PackageInitProc *) NULL);
 #endif /* TCL_TEST */
 
+	if (zygote_path != NULL)
+		return zygote_serve(interp, zygote_path);
 	return TCL_OK;
 }
 
@@ -0,0 +1,314 @@
+/* -*-	Mode:C++; c-basic-offset:8; tab-width:8; indent-tabs-mode:t -*- */
+/*
+ * Fork server ("zygote") for fast startup.  See zygote.h.
+ *
+ * A client sends the length of its request, its number of arguments
+ * and its umask together with its stdin, stdout and stderr
+ * (SCM_RIGHTS), then the request itself: its cwd, its arguments and
+ * its environment, each nul-terminated.  For each client the zygote
+ * forks a waiter, which forks the process that runs the script in a
+ * session of its own.  The waiter sends the client that process' pid,
+ * so that the client can forward signals to it, and its wait() status
+ * once it is done.
+ */
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef WIN32
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+#endif
+#include "zygote.h"
+
+#ifdef WIN32
+
+int zygote_attach(const char *, int, char **)
+{
+	return (-1);
+}
+
+int zygote_serve(Tcl_Interp *, const char *path)
+{
+	fprintf(stderr, "ns: no zygote support\n");
+	exit(1);
+}
+
+#else
+
+extern char **environ;
+
+#if TCL_MAJOR_VERSION == 8 && TCL_MINOR_VERSION < 5
+/* exported by Tcl 8.4, which has no Tcl_SetStartupScript() */
+extern "C" void TclSetStartupScriptFileName(const char *);
+#endif
+
+static int zygote_socket(const char *path, struct sockaddr_un *sa)
+{
+	if (strlen(path) >= sizeof(sa->sun_path))
+		return (-1);
+	memset(sa, 0, sizeof(*sa));
+	sa->sun_family = AF_UNIX;
+	strcpy(sa->sun_path, path);
+	return (socket(AF_UNIX, SOCK_STREAM, 0));
+}
+
+static int write_all(int fd, const char *buf, int len)
+{
+	while (len > 0) {
+		int k = write(fd, buf, len);
+		if (k < 0) {
+			if (errno == EINTR)
+				continue;
+			return (-1);
+		}
+		buf += k;
+		len -= k;
+	}
+	return (0);
+}
+
+static int read_all(int fd, char *buf, int len)
+{
+	while (len > 0) {
+		int k = read(fd, buf, len);
+		if (k < 0 && errno == EINTR)
+			continue;
+		if (k <= 0)
+			return (-1);
+		buf += k;
+		len -= k;
+	}
+	return (0);
+}
+
+/* the process running our script, and the signals passed on to it */
+static pid_t zygote_pid;
+static const int zygote_signals[] = { SIGHUP, SIGINT, SIGQUIT, SIGTERM };
+
+static void zygote_forward(int sig)
+{
+	// to its process group, unless it has not made one yet
+	if (kill(-zygote_pid, sig) < 0)
+		kill(zygote_pid, sig);
+}
+
+int zygote_attach(const char *path, int argc, char **argv)
+{
+	struct sockaddr_un sa;
+	char cwd[4096];
+	int s = zygote_socket(path, &sa);
+	if (s < 0)
+		return (-1);
+	if (connect(s, (struct sockaddr *)&sa, sizeof(sa)) < 0 ||
+	    getcwd(cwd, sizeof(cwd)) == NULL) {
+		close(s);
+		return (-1);
+	}
+	int len = strlen(cwd) + 1, i;
+	for (i = 0; i < argc; i++)
+		len += strlen(argv[i]) + 1;
+	for (i = 0; environ[i] != NULL; i++)
+		len += strlen(environ[i]) + 1;
+	char *req = new char[len];
+	char *p = req;
+	strcpy(p, cwd);
+	p += strlen(p) + 1;
+	for (i = 0; i < argc; i++) {
+		strcpy(p, argv[i]);
+		p += strlen(p) + 1;
+	}
+	for (i = 0; environ[i] != NULL; i++) {
+		strcpy(p, environ[i]);
+		p += strlen(p) + 1;
+	}
+	mode_t mask = umask(0);
+	umask(mask);
+	int hdr[3] = { len, argc, (int)mask };
+
+	int fds[3] = { 0, 1, 2 };
+	char ctl[CMSG_SPACE(sizeof(fds))];
+	struct iovec iov;
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	iov.iov_base = (char *)hdr;
+	iov.iov_len = sizeof(hdr);
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = ctl;
+	msg.msg_controllen = sizeof(ctl);
+	struct cmsghdr *cm = CMSG_FIRSTHDR(&msg);
+	cm->cmsg_level = SOL_SOCKET;
+	cm->cmsg_type = SCM_RIGHTS;
+	cm->cmsg_len = CMSG_LEN(sizeof(fds));
+	memcpy(CMSG_DATA(cm), fds, sizeof(fds));
+	if (sendmsg(s, &msg, 0) != sizeof(hdr)) {
+		delete [] req;
+		close(s);
+		return (-1);
+	}
+
+	int status;
+	if (write_all(s, req, len) < 0 ||
+	    read_all(s, (char *)&zygote_pid, sizeof(zygote_pid)) < 0) {
+		fprintf(stderr, "ns: lost the zygote at %s\n", path);
+		delete [] req;
+		close(s);
+		return (1);
+	}
+	if (zygote_pid > 0)
+		for (i = 0; i < (int)(sizeof(zygote_signals) /
+				      sizeof(zygote_signals[0])); i++)
+			signal(zygote_signals[i], zygote_forward);
+	if (read_all(s, (char *)&status, sizeof(status)) < 0) {
+		fprintf(stderr, "ns: lost the zygote at %s\n", path);
+		status = 1 << 8;
+	}
+	delete [] req;
+	close(s);
+	if (WIFSIGNALED(status)) {
+		signal(WTERMSIG(status), SIG_DFL);
+		kill(getpid(), WTERMSIG(status));
+	}
+	return (WIFEXITED(status) ? WEXITSTATUS(status) : 1);
+}
+
+/*
+ * In a child of the zygote: read the request from connection c, then
+ * fork the process to run it and wait for it.  Returns (TCL_OK) only
+ * in that process.
+ */
+static int zygote_child(Tcl_Interp *interp, int c)
+{
+	int hdr[3], fds[3];
+	char ctl[CMSG_SPACE(sizeof(fds))];
+	struct iovec iov;
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	iov.iov_base = (char *)hdr;
+	iov.iov_len = sizeof(hdr);
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = ctl;
+	msg.msg_controllen = sizeof(ctl);
+	struct cmsghdr *cm;
+	if (recvmsg(c, &msg, 0) != sizeof(hdr) ||
+	    (cm = CMSG_FIRSTHDR(&msg)) == NULL ||
+	    cm->cmsg_type != SCM_RIGHTS ||
+	    cm->cmsg_len != CMSG_LEN(sizeof(fds)) || hdr[0] <= 0 ||
+	    hdr[1] <= 0)
+		_exit(1);
+	int len = hdr[0];
+	memcpy(fds, CMSG_DATA(cm), sizeof(fds));
+	char *req = new char[len];
+	if (read_all(c, req, len) < 0 || req[len - 1] != 0)
+		_exit(1);
+
+	pid_t pid = fork();
+	if (pid != 0) {
+		int i, status = 1 << 8;
+		for (i = 0; i < 3; i++)
+			close(fds[i]);
+		write_all(c, (char *)&pid, sizeof(pid));
+		while (pid > 0 && waitpid(pid, &status, 0) < 0 &&
+		       errno == EINTR)
+			;
+		write_all(c, (char *)&status, sizeof(status));
+		_exit(0);
+	}
+	close(c);
+	setsid();
+	umask((mode_t)hdr[2]);
+	// whatever the zygote was started with, take the signals the
+	// client forwards
+	for (int i = 0; i < (int)(sizeof(zygote_signals) /
+				  sizeof(zygote_signals[0])); i++)
+		signal(zygote_signals[i], SIG_DFL);
+	for (int i = 0; i < 3; i++) {
+		dup2(fds[i], i);
+		if (fds[i] > 2)
+			close(fds[i]);
+	}
+
+	// cwd, then the script and its arguments, then the environment
+	int argc = 0;
+	char **argv = new char*[hdr[1]];
+	char *cwd = req;
+	char *p = req + strlen(req) + 1;
+	for (; p < req + len && argc < hdr[1]; p += strlen(p) + 1)
+		argv[argc++] = p;
+	if (chdir(cwd) < 0 || argc == 0) {
+		fprintf(stderr, "ns: cannot run in %s\n", cwd);
+		exit(1);
+	}
+	// replace the zygote's environment through the env array, which
+	// keeps Tcl's copy and environ in step
+	Tcl_Eval(interp, "foreach n [array names env] { unset env($n) }");
+	for (; p < req + len; p += strlen(p) + 1) {
+		char *eq = strchr(p, '=');
+		if (eq == NULL || eq == p)
+			continue;
+		*eq = 0;
+		Tcl_SetVar2(interp, "env", p, eq + 1, TCL_GLOBAL_ONLY);
+	}
+	char *args = Tcl_Merge(argc - 1, argv + 1);
+	char buf[32];
+	sprintf(buf, "%d", argc - 1);
+	Tcl_SetVar(interp, "argv0", argv[0], TCL_GLOBAL_ONLY);
+	Tcl_SetVar(interp, "argv", args, TCL_GLOBAL_ONLY);
+	Tcl_SetVar(interp, "argc", buf, TCL_GLOBAL_ONLY);
+	Tcl_SetVar(interp, "tcl_interactive", "0", TCL_GLOBAL_ONLY);
+#if TCL_MAJOR_VERSION == 8 && TCL_MINOR_VERSION < 5
+	TclSetStartupScriptFileName(argv[0]);
+#else
+	Tcl_SetStartupScript(Tcl_NewStringObj(argv[0], -1), NULL);
+#endif
+	Tcl_Free(args);
+	delete [] argv;
+	return (TCL_OK);
+}
+
+int zygote_serve(Tcl_Interp *interp, const char *path)
+{
+	struct sockaddr_un sa;
+	int s = zygote_socket(path, &sa);
+	if (s < 0) {
+		fprintf(stderr, "ns: bad zygote path %s\n", path);
+		exit(1);
+	}
+	/* Remove a stale zygote socket, but never a regular file. */
+	struct stat st;
+	if (lstat(path, &st) == 0 && S_ISSOCK(st.st_mode))
+		unlink(path);
+	if (bind(s, (struct sockaddr *)&sa, sizeof(sa)) < 0 ||
+	    listen(s, 64) < 0) {
+		perror(path);
+		exit(1);
+	}
+	Tcl_Flush(Tcl_GetStdChannel(TCL_STDOUT));
+	fflush(NULL);
+	for (;;) {
+		int c = accept(s, NULL, NULL);
+		if (c < 0) {
+			if (errno == EINTR)
+				continue;
+			perror(path);
+			exit(1);
+		}
+		pid_t pid = fork();
+		if (pid == 0) {
+			close(s);
+			return (zygote_child(interp, c));
+		}
+		close(c);
+		while (waitpid(-1, NULL, WNOHANG) > 0)
+			;
+	}
+}
+
+#endif /* WIN32 */
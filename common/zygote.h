@@ -0,0 +1,32 @@
+/* -*-	Mode:C++; c-basic-offset:8; tab-width:8; indent-tabs-mode:t -*- */
+/*
+ * Fork server ("zygote") for fast startup of short simulations.
+ *
+ *	ns -zygote /tmp/ns.sock &
+ *	NS_ZYGOTE=/tmp/ns.sock ns script.tcl args ...
+ *
+ * The zygote starts once, loads the embedded Tcl library and binds all
+ * the TclClasses, then waits on a Unix socket.  An ns started with
+ * NS_ZYGOTE set does not initialize anything: it hands its cwd, its
+ * arguments, its environment, its umask and its stdin, stdout and
+ * stderr to the zygote, which forks a copy of the initialized
+ * interpreter to run the script, and exits with the script's exit
+ * status.  The script runs in a session of its own; SIGHUP, SIGINT,
+ * SIGQUIT and SIGTERM sent to the client are passed on to it.  If the
+ * zygote cannot be reached, ns starts normally.
+ */
+
+#ifndef ns_zygote_h
+#define ns_zygote_h
+
+#include "config.h"
+
+/* run argv (script and arguments) in the zygote at path; returns the
+ * exit status for the caller, or -1 if the zygote is not reachable */
+int zygote_attach(const char *path, int argc, char **argv);
+
+/* serve the zygote at path; returns TCL_OK only in a child that is to
+ * run a client's script, which has been set as the startup script */
+int zygote_serve(Tcl_Interp *interp, const char *path);
+
+#endif
@@ -318,6 +318,7 @@ DSDV_Agent::helper_callback (Event * e)
 	      pr2->advertise_ok_at = now;
 	      pr2->advert_metric = true;
 	      pr2->advert_seqnum = true;
+	      table_->MarkChanged(pr2);
 	      pr2->seqnum++;
 	      // And we have routing info to propogate.
 	      //DEBUG
@@ -435,11 +436,14 @@ DSDV_Agent::makeUpdate(int& periodic)
   hdr_cmn *hdrc = HDR_CMN (p);
   double now = Scheduler::instance ().clock ();
   rtable_ent *prte;
+  rtable_ent **chg;
   unsigned char *walk;
 
   int change_count;             // count of entries to go in this update
   int rtbl_sz;			// counts total entries in rt table
   int unadvertiseable;		// number of routes we can't advertise yet
+  int nchg;			// entries on the table's change list
+  int i;
 
   //printf("Update packet from %d [per=%d]\n", myaddr_, periodic);
 
@@ -449,19 +453,13 @@ DSDV_Agent::makeUpdate(int& periodic)
   iph->daddr() = IP_BROADCAST << Address::instance().nodeshift();
   iph->dport() = ROUTER_PORT;
 
+  // only the entries on the change list can go in a triggered update
   change_count = 0;
-  rtbl_sz = 0;
-  unadvertiseable = 0;
-  for (table_->InitLoop (); 
-       (prte = table_->NextLoop ()); )
-    {
-      rtbl_sz++;
-      if ((prte->advert_seqnum || prte->advert_metric) 
-	  && prte->advertise_ok_at <= now) 
-	change_count++;
-
-      if (prte->advertise_ok_at > now) unadvertiseable++;
-    }
+  rtbl_sz = table_->Size();
+  nchg = table_->ChangedEntries(chg);
+  for (i = 0; i < nchg; i++)
+    if (chg[i]->advertise_ok_at <= now)
+      change_count++;
   //printf("change_count = %d\n",change_count);
   if (change_count * 3 > rtbl_sz && change_count > 3)
     { // much of the table has changed, just do a periodic update now
@@ -471,6 +469,10 @@ DSDV_Agent::makeUpdate(int& periodic)
   // Periodic update... increment the sequence number...
   if (periodic)
     {
+      unadvertiseable = 0;
+      for (table_->InitLoop (); 
+	   (prte = table_->NextLoop ()); )
+	if (prte->advertise_ok_at > now) unadvertiseable++;
       change_count = rtbl_sz - unadvertiseable;
       //printf("rtbsize-%d, unadvert-%d\n",rtbl_sz,unadvertiseable);
       rtable_ent rte;
@@ -520,7 +522,12 @@ DSDV_Agent::makeUpdate(int& periodic)
   // hdrc->size_ = change_count * 12 + 20;	// DSDV + IP
   hdrc->size_ = change_count * 12 + IP_HDR_LEN;	// DSDV + IP
 
-  for (table_->InitLoop (); (prte = table_->NextLoop ());)
+  // a periodic update is a full dump, a triggered one only needs
+  // the change list
+  if (periodic)
+    table_->InitLoop ();
+  for (i = 0; (prte = periodic ? table_->NextLoop () :
+	       (i < nchg ? chg[i++] : 0)); )
     {
 
       if (periodic && prte->advertise_ok_at > now)
@@ -762,6 +769,7 @@ DSDV_Agent::processUpdate (Packet * p)
 	      // about our more glorious and happy metric
 	      prte->advertise_ok_at = now;
 	      prte->advert_metric = true;
+	      table_->MarkChanged(prte);
 	      // directly schedule a triggered update now for 
 	      // prte, since the other logic only works with rte.*
 	      needTriggeredUpdate(prte,now);
@@ -52,6 +52,11 @@ RoutingTable::RoutingTable() {
   elts = 0;
   maxelts = 10;
   rtab = new rtable_ent[maxelts];
+
+  nchg = 0;
+  maxchg = maxelts;
+  chglist = new nsaddr_t[maxchg];
+  chgents = new rtable_ent*[maxchg];
 }
 
 void
@@ -63,7 +68,11 @@ RoutingTable::AddEntry(const rtable_ent &ent)
 
   if ((it = (rtable_ent*) bsearch(&ent, rtab, elts, sizeof(rtable_ent), 
 				 rtent_trich))) {
+    bool listed = it->on_chglist;
     bcopy(&ent,it,sizeof(rtable_ent));
+    it->on_chglist = listed;
+    if (it->advert_seqnum || it->advert_metric)
+      MarkChanged(it);
     return;
     /*
     if (it->seqnum < ent.seqnum || it->metric > (ent.metric+em)) {
@@ -104,7 +113,10 @@ RoutingTable::AddEntry(const rtable_ent &ent)
   }
   //}
   bcopy(&ent, &rtab[max], sizeof(rtable_ent));
+  rtab[max].on_chglist = false;
   elts++;
+  if (ent.advert_seqnum || ent.advert_metric)
+    MarkChanged(&rtab[max]);
 
   return;
 }
@@ -135,3 +147,53 @@ RoutingTable::GetEntry(nsaddr_t dest) {
   return (rtable_ent *) bsearch(&ent, rtab, elts, sizeof(rtable_ent), 
 				rtent_trich);
 }
+
+void
+RoutingTable::MarkChanged(rtable_ent *prte)
+{
+  if (prte->on_chglist)
+    return;
+  if (nchg == maxchg) {
+    nsaddr_t *tmp = chglist;
+    maxchg *= 2;
+    chglist = new nsaddr_t[maxchg];
+    bcopy(tmp, chglist, nchg*sizeof(nsaddr_t));
+    delete [] tmp;
+    delete [] chgents;
+    chgents = new rtable_ent*[maxchg];
+  }
+  chglist[nchg++] = prte->dst;
+  prte->on_chglist = true;
+}
+
+static int chg_trich(const void *a, const void *b) {
+  nsaddr_t ia = *(const nsaddr_t *) a;
+  nsaddr_t ib = *(const nsaddr_t *) b;
+  if (ia > ib) return 1;
+  if (ib > ia) return -1;
+  return 0;
+}
+
+int
+RoutingTable::ChangedEntries(rtable_ent **&ents)
+{
+  int i, n = 0;
+
+  // drop the entries that have been advertised since they were listed
+  for (i = 0; i < nchg; i++) {
+    rtable_ent *prte = GetEntry(chglist[i]);
+    if (prte == 0)
+      continue;
+    if (prte->advert_seqnum || prte->advert_metric)
+      chglist[n++] = chglist[i];
+    else
+      prte->on_chglist = false;
+  }
+  nchg = n;
+
+  qsort(chglist, nchg, sizeof(nsaddr_t), chg_trich);
+  for (i = 0; i < nchg; i++)
+    chgents[i] = GetEntry(chglist[i]);
+  ents = chgents;
+  return nchg;
+}
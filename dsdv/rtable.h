@@ -86,6 +86,7 @@ public:
   double       wst;     // running wst info
   Event       *timeout_event; // event used to schedule timeout action
   PacketQueue *q;		//pkts queued for dst
+  bool         on_chglist; // dst is on the table's change list
 };
 
 // AddEntry adds an entry to the routing table with metric ent->metric+em.
@@ -101,12 +102,29 @@ class RoutingTable {
     void InitLoop();
     rtable_ent *NextLoop();
     rtable_ent *GetEntry(nsaddr_t dest);
+    int Size() { return elts; }
+
+    // The change list holds (at least) every destination whose entry
+    // has advert_seqnum or advert_metric set, so triggered updates
+    // don't have to look at the whole table.  AddEntry marks entries
+    // itself; code that sets the flags through a pointer must call
+    // MarkChanged.
+    void MarkChanged(rtable_ent *prte);
+    // Sets ents to the entries of the change list that still have a
+    // flag set, in table order, and returns their number.  The array
+    // is only valid until the next AddEntry or ChangedEntries.
+    int ChangedEntries(rtable_ent **&ents);
 
   private:
     rtable_ent *rtab;
     int         maxelts;
     int         elts;
     int         ctr;
+
+    nsaddr_t   *chglist;
+    rtable_ent **chgents;
+    int         nchg;
+    int         maxchg;
 };
     
 #endif
@@ -175,6 +175,7 @@ friend class MobiHandler;
 
 public:
 	LinkCache();
+	~LinkCache();
 
 	void noticeDeadLink(const ID&from, const ID& to, Time t);
 	// the link from->to isn't working anymore, purge routes containing
@@ -230,6 +231,23 @@ private:
 	double exptable[LC_MAX_NODES + 1];
 #define INFINITY 0x7fffffff
 
+	// Priority queue of the nodes whose estimate was improved, so
+	// extract_min_q() doesn't scan all LC_MAX_NODES each time.
+	// Entries are not removed when a node improves again, stale
+	// ones are skipped when they come out.
+	struct dq_entry {
+		u_int32_t d;
+#ifdef LONGEST_LIVED_ROUTE
+		double dl;
+#endif
+		int u;
+	} *dq;
+	int dq_len;
+	int dq_max;
+
+	void dq_push(int u);
+	bool dq_less(const dq_entry& a, const dq_entry& b);
+
 	void init_single_source(int s);
 #ifdef LONGEST_LIVED_ROUTE
 	void relax(u_int32_t u, u_int32_t v, u_int32_t w, double);
@@ -297,6 +315,15 @@ LinkCache::LinkCache() : RouteCache()
 	stat.reset();
 #endif
 	dirty = -1;
+
+	dq_max = 64;
+	dq = new dq_entry[dq_max];
+	dq_len = 0;
+}
+
+LinkCache::~LinkCache()
+{
+	delete [] dq;
 }
 
 
@@ -617,6 +644,8 @@ LinkCache::init_single_source(int s)
 #ifdef LONGEST_LIVED_ROUTE
 	dl[s] = MAX_SIMTIME;
 #endif
+	dq_len = 0;
+	dq_push(s);
 }
 
 void
@@ -639,27 +668,80 @@ LinkCache::relax(u_int32_t u, u_int32_t v, u_int32_t w)
 		dl[v] = (dl[u] > timeout) ? timeout : dl[u];
 #endif
 		pi[v] = u;
+		dq_push(v);
 	}
 }
 
+/*
+ * The order extract_min_q() takes the nodes in: shortest first, then
+ * longest lived, then lowest address.
+ */
+bool
+LinkCache::dq_less(const dq_entry& a, const dq_entry& b)
+{
+	if(a.d != b.d)
+		return a.d < b.d;
+#ifdef LONGEST_LIVED_ROUTE
+	if(a.dl != b.dl)
+		return a.dl > b.dl;
+#endif
+	return a.u < b.u;
+}
+
+void
+LinkCache::dq_push(int u)
+{
+	if(dq_len == dq_max) {
+		dq_entry *n = new dq_entry[2 * dq_max];
+		memcpy(n, dq, dq_len * sizeof(dq_entry));
+		delete [] dq;
+		dq = n;
+		dq_max *= 2;
+	}
+
+	int i = dq_len++;
+	dq_entry e;
+	e.d = d[u];
+#ifdef LONGEST_LIVED_ROUTE
+	e.dl = dl[u];
+#endif
+	e.u = u;
+	while(i > 0 && dq_less(e, dq[(i - 1) / 2])) {
+		dq[i] = dq[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	dq[i] = e;
+}
+
 
 int
 LinkCache::extract_min_q()
 {
-	int u;
-	int min_u = 0;
+	while(dq_len > 0) {
+		dq_entry top = dq[0];
+		dq_entry last = dq[--dq_len];
+		int i = 0, c;
+
+		while((c = 2 * i + 1) < dq_len) {
+			if(c + 1 < dq_len && dq_less(dq[c + 1], dq[c]))
+				c++;
+			if(!dq_less(dq[c], last))
+				break;
+			dq[i] = dq[c];
+			i = c;
+		}
+		dq[i] = last;
 
-	for(u = 1; u <= LC_MAX_NODES; u++) {
-		if(S[u] == false && d[u] < INFINITY && 
-		   (min_u == 0 || d[u] < d[min_u] 
+		// skip nodes already done and superseded estimates
+		if(S[top.u] || top.d != d[top.u]
 #ifdef LONGEST_LIVED_ROUTE
-		    || (d[u] == d[min_u] && dl[u] > dl[min_u])
+		   || top.dl != dl[top.u]
 #endif
-		   )) {
-			min_u = u;
-		}
+		   )
+			continue;
+		return top.u;
 	}
-	return min_u; // (min_u == 0) ==> no valid link
+	return 0; // ==> no valid link
 }
 
 void
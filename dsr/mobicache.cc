@@ -107,6 +107,11 @@ public:
   bool searchRoute(const ID& dest, int& i, Path &path, int &index);
   // look for dest in cache, starting at index, 
   //if found, rtn true with path s.t. cache[index] == path && path[i] == dest
+  bool findShortest(const ID& dest, int& i, int &index);
+  // same result as the first searchRoute() with the smallest i, using
+  // the index: rtns true with cache[index][i] == dest
+  void truncate(int index, int len);
+  // cut cache[index] down to len ids, keeping the index up to date
   Path* addRoute(Path &route, int &prefix_len);
   // rtns a pointer the path in the cache that we added
   void noticeDeadLink(const ID&from, const ID& to);
@@ -114,13 +119,30 @@ public:
   // it from the cache
 
 private:
+  void indexPath(int index, int from);
+  // add the ids at positions from.. of cache[index] to the index
+
   Path *cache;
   int size;
   int victim_ptr;		// next victim for eviction
   MobiCache *routecache;
   char *name;
+
+  // Inverted index, id -> (path, position), so that lookups don't have
+  // to scan every path in the cache.  Posting k stands for position
+  // k % MAX_SR_LEN of cache[k / MAX_SR_LEN]; the postings of the ids
+  // that hash to the same bucket are on a doubly linked list.
+  int *bucket;			// first posting of each bucket, or -1
+  int *pnext;
+  int *pprev;			// previous posting, or -1 - bucket
+  int *pbucket;			// bucket of the posting, -1 if unused
+  int *dead;			// scratch for noticeDeadLink()
 };
 
+#define CACHE_NBUCKETS	256
+#define CACHE_HASH(id)	((((id).addr * 2654435761UL) >> 8 ^ (id).type) & \
+			 (CACHE_NBUCKETS - 1))
+
 ///////////////////////////////////////////////////////////////////////////
 
 class MobiCache : public RouteCache {
@@ -376,7 +398,6 @@ MobiCache::findRoute(ID dest, Path& route, int for_me)
 // the returned route so it will be promoted to primary storage if not there
 // already
 {
-  Path path;
   int min_index = -1;
   int min_length = MAX_SR_LEN + 1;
   int min_cache = 0;		// 2 == primary, 1 = secondary
@@ -385,29 +406,21 @@ MobiCache::findRoute(ID dest, Path& route, int for_me)
 
   assert(!(net_id == invalid_addr));
 
-  index = 0;
-  while (primary_cache->searchRoute(dest, len, path, index))
+  // the shortest route, the first one in the cache if there are
+  // several, preferring the primary cache
+  if (primary_cache->findShortest(dest, len, index))
     {
       min_cache = 2;
-      if (len < min_length)
-	{
-	  min_length = len;
-	  route = path;
-	}
-      index++;
+      min_length = len;
+      route = primary_cache->cache[index];
     }
   
-  index = 0;
-  while (secondary_cache->searchRoute(dest, len, path, index))
+  if (secondary_cache->findShortest(dest, len, index) && len < min_length)
     {
-      if (len < min_length)
-	{
-	  min_index = index;
-	  min_cache = 1;
-	  min_length = len;
-	  route = path;
-	}
-      index++;
+      min_index = index;
+      min_cache = 1;
+      min_length = len;
+      route = secondary_cache->cache[index];
     }
 
   if (min_cache == 1 && for_me)
@@ -432,13 +445,13 @@ MobiCache::findRoute(ID dest, Path& route, int for_me)
       //          entry as "evicted"
       if(prefix_len > 0)
         {
-          secondary_cache->cache[min_index].setLength(prefix_len);
+          secondary_cache->truncate(min_index, prefix_len);
 #ifdef DSR_CACHE_STATS
           checkRoute_logall(&secondary_cache->cache[min_index], 
                             ACTION_EVICT, 0);
 #endif
         }
-      secondary_cache->cache[min_index].setLength(0); // kill route
+      secondary_cache->truncate(min_index, 0); // kill route
     }
 
   if (min_cache) 
@@ -485,11 +498,84 @@ Cache::Cache(char *name, int size, MobiCache *rtcache)
   cache = new Path[size];
   routecache = rtcache;
   victim_ptr = 0;
+
+  bucket = new int[CACHE_NBUCKETS];
+  for (int b = 0; b < CACHE_NBUCKETS; b++)
+    bucket[b] = -1;
+  pnext = new int[size * MAX_SR_LEN];
+  pprev = new int[size * MAX_SR_LEN];
+  pbucket = new int[size * MAX_SR_LEN];
+  for (int k = 0; k < size * MAX_SR_LEN; k++)
+    pbucket[k] = -1;
+  dead = new int[size];
 }
 
 Cache::~Cache() 
 {
   delete[] cache;
+  delete[] bucket;
+  delete[] pnext;
+  delete[] pprev;
+  delete[] pbucket;
+  delete[] dead;
+}
+
+void
+Cache::indexPath(int index, int from)
+{
+  for (int n = from; n < cache[index].length(); n++)
+    {
+      int k = index * MAX_SR_LEN + n;
+      int b = CACHE_HASH(cache[index][n]);
+      assert(pbucket[k] < 0);
+      pbucket[k] = b;
+      pprev[k] = -1 - b;
+      pnext[k] = bucket[b];
+      if (bucket[b] >= 0)
+	pprev[bucket[b]] = k;
+      bucket[b] = k;
+    }
+}
+
+void
+Cache::truncate(int index, int len)
+{
+  for (int n = len; n < cache[index].length(); n++)
+    {
+      int k = index * MAX_SR_LEN + n;
+      if (pprev[k] >= 0)
+	pnext[pprev[k]] = pnext[k];
+      else
+	bucket[pbucket[k]] = pnext[k];
+      if (pnext[k] >= 0)
+	pprev[pnext[k]] = pprev[k];
+      pbucket[k] = -1;
+    }
+  if (len == 0)
+    cache[index].reset();
+  else
+    cache[index].setLength(len);
+}
+
+bool
+Cache::findShortest(const ID& dest, int& i, int &index)
+{
+  int best = -1;
+
+  for (int k = bucket[CACHE_HASH(dest)]; k >= 0; k = pnext[k])
+    {
+      int c = k / MAX_SR_LEN, n = k % MAX_SR_LEN;
+      if (!(cache[c][n] == dest))
+	continue;
+      if (best < 0 || n < best % MAX_SR_LEN ||
+	  (n == best % MAX_SR_LEN && c < best / MAX_SR_LEN))
+	best = k;
+    }
+  if (best < 0)
+    return false;
+  index = best / MAX_SR_LEN;
+  i = best % MAX_SR_LEN;
+  return true;
 }
 
 bool 
@@ -511,12 +597,32 @@ Cache::searchRoute(const ID& dest, int& i, Path &path, int &index)
 Path*
 Cache::addRoute(Path & path, int &common_prefix_len)
 {
-  int index, m, n;
+  int index, m, n, c, k;
   int victim;
 
-  // see if this route is already in the cache
-  for (index = 0 ; index < size ; index++)
-    { // for all paths in the cache
+  // see if this route is already in the cache: find the first path
+  // that is empty, a prefix of the new route or has it as a prefix.
+  // A path of length l that is a prefix has path[l-1] at l-1, and one
+  // that contains the new route has path[path.length()-1] there, so
+  // only these postings are checked.
+  assert(path.length() > 0);
+  for (index = 0; index < size && cache[index].length() > 0; index++)
+    ;
+  for (n = 0; n < path.length(); n++)
+    for (k = bucket[CACHE_HASH(path[n])]; k >= 0; k = pnext[k])
+      {
+	c = k / MAX_SR_LEN;
+	if (k % MAX_SR_LEN != n || c >= index || cache[c][n] != path[n])
+	  continue;
+	if (cache[c].length() != n + 1 && n != path.length() - 1)
+	  continue;
+	for (m = 0; m < n && cache[c][m] == path[m]; m++)
+	  ;
+	if (m == n)
+	  index = c;
+      }
+  if (index < size)
+    {
       for (n = 0 ; n < cache[index].length() ; n ++)
 	{ // for all nodes in the path
 	  if (n >= path.length()) break;
@@ -527,14 +633,16 @@ Cache::addRoute(Path & path, int &common_prefix_len)
           common_prefix_len = n;
           for ( ; n < path.length() ; n++)
             cache[index].appendToPath(path[n]);
+          indexPath(index, common_prefix_len);
 	  if (verbose_debug)
 	    routecache->trace("SRC %.9f _%s_ %s suffix-rule (len %d/%d) %s",
    	      Scheduler::instance().clock(), routecache->net_id.dump(),
               name, n, path.length(), path.dump());	
 	  goto done;
 	}
-      else if (n == path.length())
+      else
 	{ // new route already contained in the cache
+	  assert(n == path.length());
           common_prefix_len = n;
 	  if (verbose_debug)
 	    routecache->trace("SRC %.9f _%s_ %s prefix-rule (len %d/%d) %s",
@@ -542,9 +650,6 @@ Cache::addRoute(Path & path, int &common_prefix_len)
 	      name, n, cache[index].length(), cache[index].dump());	
 	  goto done;
 	}
-      else 
-	{ // keep looking at the rest of the cache 
-	}
     } 
 
   // there are some new goodies in the new route
@@ -557,8 +662,9 @@ Cache::addRoute(Path & path, int &common_prefix_len)
 		      Scheduler::instance().clock(), routecache->net_id.dump(),
 		      path.dump());	
   }
-  cache[victim].reset();
+  truncate(victim, 0);
   CopyIntoPath(cache[victim], path, 0, path.length() - 1);
+  indexPath(victim, 0);
   common_prefix_len = 0;
   index = victim; // remember which cache line we stuck the path into
 
@@ -578,9 +684,15 @@ done:
   }
 #endif //DEBUG
 
-  // freshen all the timestamps on the links in the cache
-  for (m = 0 ; m < size ; m++)
-    { // for all paths in the cache
+  // freshen all the timestamps on the links in the cache.  Only the
+  // paths that start with the first link of the new route share a link
+  // with it, and they all have path[1] at position 1.
+  for (k = path.length() > 1 ? bucket[CACHE_HASH(path[1])] : -1;
+       k >= 0; k = pnext[k])
+    {
+      if (k % MAX_SR_LEN != 1)
+	continue;
+      m = k / MAX_SR_LEN;
 
 #ifdef DEBUG
   {
@@ -628,38 +740,60 @@ Cache::noticeDeadLink(const ID&from, const ID& to)
   // the link from->to isn't working anymore, purge routes containing
   // it from the cache
 {  
-  for (int p = 0 ; p < size ; p++)
-    { // for all paths in the cache
-      for (int n = 0 ; n < (cache[p].length()-1) ; n ++)
-	{ // for all nodes in the path
-	  if (cache[p][n] == from && cache[p][n+1] == to)
-	    {
-	      if(verbose_debug)
-		routecache->trace("SRC %.9f _%s_ %s truncating %s %s",
-                                  Scheduler::instance().clock(),
-                                  routecache->net_id.dump(),
-                                  name, cache[p].dump(),
-                                  cache[p].owner().dump());
+  int ndead = 0;
+  int k, c;
+
+  // the paths with from followed by to, from the index
+  for (k = bucket[CACHE_HASH(from)]; k >= 0; k = pnext[k])
+    {
+      int p = k / MAX_SR_LEN, n = k % MAX_SR_LEN;
+      if (n < cache[p].length() - 1 &&
+	  cache[p][n] == from && cache[p][n+1] == to)
+	{
+	  for (c = 0; c < ndead && dead[c] / MAX_SR_LEN != p; c++)
+	    ;
+	  if (c == ndead)
+	    dead[ndead++] = k;
+	  else if (k < dead[c])
+	    dead[c] = k;
+	}
+    }
+  // in cache order, as the traces used to be
+  for (k = 1; k < ndead; k++)
+    for (c = k; c > 0 && dead[c] < dead[c-1]; c--)
+      {
+	int t = dead[c];
+	dead[c] = dead[c-1];
+	dead[c-1] = t;
+      }
+
+  for (c = 0; c < ndead; c++)
+    {
+      int p = dead[c] / MAX_SR_LEN, n = dead[c] % MAX_SR_LEN;
+
+      if(verbose_debug)
+	routecache->trace("SRC %.9f _%s_ %s truncating %s %s",
+			  Scheduler::instance().clock(),
+			  routecache->net_id.dump(),
+			  name, cache[p].dump(),
+			  cache[p].owner().dump());
 #ifdef DSR_CACHE_STATS
-              routecache->checkRoute(&cache[p], ACTION_CHECK_CACHE, 0);
-              routecache->checkRoute_logall(&cache[p], ACTION_DEAD_LINK, n);
+      routecache->checkRoute(&cache[p], ACTION_CHECK_CACHE, 0);
+      routecache->checkRoute_logall(&cache[p], ACTION_DEAD_LINK, n);
 #endif	      
-	      if (n == 0)
-		cache[p].reset();        // kill the whole path
-	      else {
-		cache[p].setLength(n+1); // truncate the path here
-                cache[p][n].log_stat = LS_UNLOGGED;
-              }
-
-	      if(verbose_debug)
-		routecache->trace("SRC %.9f _%s_ to %s %s",
-		      Scheduler::instance().clock(), routecache->net_id.dump(),
-		      cache[p].dump(), cache[p].owner().dump());
-
-	      break;
-	    } // end if this is a dead link
-	} // end for all nodes
-    } // end for all paths
+      if (n == 0)
+	truncate(p, 0);           // kill the whole path
+      else {
+	truncate(p, n+1);         // truncate the path here
+	cache[p][n].log_stat = LS_UNLOGGED;
+      }
+
+      if(verbose_debug)
+	routecache->trace("SRC %.9f _%s_ to %s %s",
+			  Scheduler::instance().clock(),
+			  routecache->net_id.dump(),
+			  cache[p].dump(), cache[p].owner().dump());
+    } // end for all paths with the dead link
   return;
 }
 
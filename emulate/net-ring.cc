@@ -0,0 +1,388 @@
+/* -*-	Mode:C++; c-basic-offset:8; tab-width:8; indent-tabs-mode:t -*- */
+/*
+ * Network/Packet/Ring: a live Ethernet interface read and written
+ * through Linux AF_PACKET TPACKET_V3 rings mapped into ns.
+ *
+ *	set net [new Network/Packet/Ring]
+ *	$net open readwrite veth1
+ *	$tap network $net
+ *
+ * The kernel fills whole blocks of the RX ring with frames and hands
+ * each block over at once (when it is full, or timeout_ after its
+ * first frame), so a single wakeup of the scheduler harvests a whole
+ * block with no system call per frame: see pending() and
+ * TapAgent::dispatch().  Sent frames are written into the TX ring and
+ * the kernel is kicked once per send; frames queued while the kernel
+ * is busy go out with the same kick.
+ *
+ * Like Network/Pcap/Live, received frames are returned without their
+ * Ethernet header and sent buffers must hold complete frames.  Frames
+ * sent by this host on the interface are not received.
+ */
+
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <net/ethernet.h>
+#include <linux/if_packet.h>
+#endif
+
+#include "config.h"
+#include "scheduler.h"
+#include "net.h"
+#include "packet.h"
+
+#if defined(__linux__) && defined(TPACKET3_HDRLEN)
+
+class RingNetwork : public Network {
+public:
+	RingNetwork();
+	~RingNetwork() { close(); }
+	int command(int argc, const char*const* argv);
+	int rchannel() { return (fd_); }
+	int schannel() { return (fd_); }
+	int send(u_char* buf, int len);
+	int recv(u_char* buf, int len, sockaddr&, double& ts);
+	int recv(netpkt_handler callback, void *clientdata);
+	int pending() { return (rleft_); }
+protected:
+	int open(int mode, const char* ifname);
+	void close();
+	tpacket3_hdr* frame();		// next received frame, or NULL
+	void next();			// done with the current frame
+	void stats();
+
+	int fd_;
+	char ifname_[IFNAMSIZ];
+	u_char* map_;			// RX ring, then TX ring
+	size_t maplen_;
+
+	int blocksize_;			// RX/TX ring block size (bytes)
+	int nblocks_;			// # of RX blocks
+	int txblocks_;			// # of TX blocks (0: no TX ring)
+	int framesize_;			// TX frame size (bytes)
+	double timeout_;		// RX block retire timeout (sec)
+	int promisc_;
+
+	int rblock_;			// current RX block
+	int rleft_;			// frames left in it
+	tpacket3_hdr* rframe_;		// current frame in it
+	u_char* tx_;			// TX ring, or NULL
+	int tframes_;			// # of TX frames
+	int tframe_;			// next TX frame
+	int pkts_;			// frames seen by the kernel
+	int pdrops_;			// and dropped for lack of ring space
+};
+
+static class RingNetworkClass : public TclClass {
+public:
+	RingNetworkClass() : TclClass("Network/Packet/Ring") {}
+	TclObject* create(int, const char*const*) {
+		return (new RingNetwork);
+	}
+} class_ring_network;
+
+RingNetwork::RingNetwork() : fd_(-1), map_(0), maplen_(0), rblock_(0),
+	rleft_(0), rframe_(0), tx_(0), tframes_(0), tframe_(0),
+	pkts_(0), pdrops_(0)
+{
+	ifname_[0] = 0;
+	bind("blocksize_", &blocksize_);
+	bind("nblocks_", &nblocks_);
+	bind("txblocks_", &txblocks_);
+	bind("framesize_", &framesize_);
+	bind_time("timeout_", &timeout_);
+	bind_bool("promisc_", &promisc_);
+}
+
+int RingNetwork::command(int argc, const char*const* argv)
+{
+	Tcl& tcl = Tcl::instance();
+	if (argc == 2) {
+		if (strcmp(argv[1], "close") == 0) {
+			close();
+			return (TCL_OK);
+		}
+		if (strcmp(argv[1], "srcname") == 0) {
+			tcl.result(ifname_);
+			return (TCL_OK);
+		}
+		if (strcmp(argv[1], "pkts") == 0) {
+			stats();
+			tcl.resultf("%d", pkts_);
+			return (TCL_OK);
+		}
+		if (strcmp(argv[1], "pdrops") == 0) {
+			stats();
+			tcl.resultf("%d", pdrops_);
+			return (TCL_OK);
+		}
+	} else if (argc == 4) {
+		// $net open mode ifname
+		if (strcmp(argv[1], "open") == 0) {
+			if (open(parsemode(argv[2]), argv[3]) < 0)
+				return (TCL_ERROR);
+			tcl.result(ifname_);
+			return (TCL_OK);
+		}
+	}
+	return (Network::command(argc, argv));
+}
+
+int RingNetwork::open(int mode, const char* ifname)
+{
+	close();
+	if (strlen(ifname) >= sizeof(ifname_)) {
+		fprintf(stderr, "Network/Packet/Ring(%s): bad interface %s\n",
+			name(), ifname);
+		return (-1);
+	}
+	long pg = sysconf(_SC_PAGESIZE);
+	if (blocksize_ <= 0 || blocksize_ % pg != 0 || nblocks_ <= 0 ||
+	    framesize_ < (int)TPACKET3_HDRLEN || framesize_ % TPACKET_ALIGNMENT ||
+	    blocksize_ % framesize_ != 0 || txblocks_ < 0) {
+		fprintf(stderr,
+		    "Network/Packet/Ring(%s): bad ring geometry "
+		    "(blocksize_ %d, framesize_ %d)\n",
+			name(), blocksize_, framesize_);
+		return (-1);
+	}
+	int ifindex = if_nametoindex(ifname);
+	if (ifindex == 0) {
+		fprintf(stderr, "Network/Packet/Ring(%s): %s: %s\n",
+			name(), ifname, strerror(errno));
+		return (-1);
+	}
+	fd_ = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+	if (fd_ < 0) {
+		perror("Network/Packet/Ring: socket");
+		return (-1);
+	}
+	int v = TPACKET_V3;
+	if (setsockopt(fd_, SOL_PACKET, PACKET_VERSION, &v, sizeof(v)) < 0) {
+		perror("Network/Packet/Ring: PACKET_VERSION");
+		close();
+		return (-1);
+	}
+
+	tpacket_req3 req;
+	memset(&req, 0, sizeof(req));
+	req.tp_block_size = blocksize_;
+	req.tp_block_nr = nblocks_;
+	req.tp_frame_size = framesize_;
+	req.tp_frame_nr = (blocksize_ / framesize_) * nblocks_;
+	req.tp_retire_blk_tov = int(timeout_ * 1000. + 0.5);
+	if (req.tp_retire_blk_tov == 0)
+		req.tp_retire_blk_tov = 1;
+	if (setsockopt(fd_, SOL_PACKET, PACKET_RX_RING,
+		       &req, sizeof(req)) < 0) {
+		perror("Network/Packet/Ring: PACKET_RX_RING");
+		close();
+		return (-1);
+	}
+	maplen_ = size_t(blocksize_) * nblocks_;
+
+	// a TX ring needs a 4.11 kernel; without it sends are copied
+	if (txblocks_ > 0 && mode != O_RDONLY) {
+		req.tp_block_nr = txblocks_;
+		req.tp_frame_nr = (blocksize_ / framesize_) * txblocks_;
+		req.tp_retire_blk_tov = 0;
+		if (setsockopt(fd_, SOL_PACKET, PACKET_TX_RING,
+			       &req, sizeof(req)) == 0) {
+			tframes_ = req.tp_frame_nr;
+			maplen_ += size_t(blocksize_) * txblocks_;
+		}
+	}
+	void* m = mmap(0, maplen_, PROT_READ|PROT_WRITE, MAP_SHARED, fd_, 0);
+	if (m == MAP_FAILED) {
+		perror("Network/Packet/Ring: mmap");
+		maplen_ = 0;
+		close();
+		return (-1);
+	}
+	map_ = (u_char*)m;
+	if (tframes_ > 0)
+		tx_ = map_ + size_t(blocksize_) * nblocks_;
+
+	sockaddr_ll sll;
+	memset(&sll, 0, sizeof(sll));
+	sll.sll_family = AF_PACKET;
+	sll.sll_protocol = htons(ETH_P_ALL);
+	sll.sll_ifindex = ifindex;
+	if (::bind(fd_, (sockaddr*)&sll, sizeof(sll)) < 0) {
+		perror("Network/Packet/Ring: bind");
+		close();
+		return (-1);
+	}
+	if (promisc_) {
+		packet_mreq mr;
+		memset(&mr, 0, sizeof(mr));
+		mr.mr_ifindex = ifindex;
+		mr.mr_type = PACKET_MR_PROMISC;
+		if (setsockopt(fd_, SOL_PACKET, PACKET_ADD_MEMBERSHIP,
+			       &mr, sizeof(mr)) < 0)
+			perror("Network/Packet/Ring: PACKET_MR_PROMISC");
+	}
+	(void) nonblock(fd_);
+	strcpy(ifname_, ifname);
+	mode_ = mode;
+	return (0);
+}
+
+void RingNetwork::close()
+{
+	if (map_ != 0)
+		munmap(map_, maplen_);
+	if (fd_ >= 0)
+		::close(fd_);
+	fd_ = -1;
+	map_ = tx_ = 0;
+	maplen_ = 0;
+	rblock_ = rleft_ = 0;
+	rframe_ = 0;
+	tframes_ = tframe_ = 0;
+	mode_ = -1;
+}
+
+/*
+ * The frame to receive next, opening the next RX block if the current
+ * one is done.  Frames sent by this host are skipped.
+ */
+tpacket3_hdr* RingNetwork::frame()
+{
+	if (map_ == 0)
+		return (0);
+	for (;;) {
+		if (rleft_ == 0) {
+			tpacket_block_desc* bd = (tpacket_block_desc*)
+				(map_ + size_t(rblock_) * blocksize_);
+			if ((bd->hdr.bh1.block_status & TP_STATUS_USER) == 0)
+				return (0);
+			__sync_synchronize();
+			rleft_ = bd->hdr.bh1.num_pkts;
+			rframe_ = (tpacket3_hdr*)
+				((u_char*)bd + bd->hdr.bh1.offset_to_first_pkt);
+			if (rleft_ == 0) {
+				rleft_ = 1;	// release it
+				next();
+				continue;
+			}
+		}
+		sockaddr_ll* sll = (sockaddr_ll*)
+			((u_char*)rframe_ + TPACKET_ALIGN(sizeof(tpacket3_hdr)));
+		if (sll->sll_pkttype != PACKET_OUTGOING &&
+		    rframe_->tp_snaplen > ETHER_HDR_LEN)
+			return (rframe_);
+		next();
+	}
+}
+
+/*
+ * Step past the current frame; the block goes back to the kernel once
+ * all its frames have been received.
+ */
+void RingNetwork::next()
+{
+	if (--rleft_ > 0) {
+		rframe_ = (tpacket3_hdr*)
+			((u_char*)rframe_ + rframe_->tp_next_offset);
+		return;
+	}
+	tpacket_block_desc* bd = (tpacket_block_desc*)
+		(map_ + size_t(rblock_) * blocksize_);
+	__sync_synchronize();
+	bd->hdr.bh1.block_status = TP_STATUS_KERNEL;
+	rblock_ = (rblock_ + 1) % nblocks_;
+	rframe_ = 0;
+}
+
+int RingNetwork::recv(u_char* buf, int len, sockaddr&, double& ts)
+{
+	tpacket3_hdr* h = frame();
+	if (h == 0)
+		return (0);
+	int n = h->tp_snaplen - ETHER_HDR_LEN;
+	if (n > len)
+		n = len;
+	memcpy(buf, (u_char*)h + h->tp_mac + ETHER_HDR_LEN, n);
+	next();
+	ts = Scheduler::instance().clock();
+	return (n);
+}
+
+/*
+ * Hand every frame already in the RX ring to callback, as a Packet
+ * holding the frame without its Ethernet header.
+ */
+int RingNetwork::recv(netpkt_handler callback, void *clientdata)
+{
+	int np = 0;
+	tpacket3_hdr* h;
+	while ((h = frame()) != 0) {
+		int n = h->tp_snaplen - ETHER_HDR_LEN;
+		Packet* p = Packet::alloc(n);
+		memcpy(p->accessdata(),
+		       (u_char*)h + h->tp_mac + ETHER_HDR_LEN, n);
+		struct timeval tv;
+		tv.tv_sec = h->tp_sec;
+		tv.tv_usec = h->tp_nsec / 1000;
+		next();
+		callback(clientdata, p, tv);
+		np++;
+	}
+	return (np);
+}
+
+int RingNetwork::send(u_char* buf, int len)
+{
+	if (fd_ < 0) {
+		errno = EBADF;
+		return (-1);
+	}
+	if (tx_ == 0)
+		return (::send(fd_, (char*)buf, len, 0));
+
+	const int off = TPACKET_ALIGN(sizeof(tpacket3_hdr));
+	if (len > framesize_ - off) {
+		errno = EMSGSIZE;
+		return (-1);
+	}
+	tpacket3_hdr* h = (tpacket3_hdr*)(tx_ + size_t(tframe_) * framesize_);
+	if (h->tp_status != TP_STATUS_AVAILABLE &&
+	    h->tp_status != TP_STATUS_WRONG_FORMAT) {
+		// ring full: nothing to do but wait for the kernel
+		errno = ENOBUFS;
+		return (-1);
+	}
+	memcpy((u_char*)h + off, buf, len);
+	h->tp_len = len;
+	h->tp_snaplen = len;
+	h->tp_next_offset = 0;
+	__sync_synchronize();
+	h->tp_status = TP_STATUS_SEND_REQUEST;
+	tframe_ = (tframe_ + 1) % tframes_;
+	if (::send(fd_, NULL, 0, MSG_DONTWAIT) < 0 &&
+	    errno != EAGAIN && errno != ENOBUFS)
+		return (-1);
+	return (len);
+}
+
+/* the kernel counters are cleared whenever they are read */
+void RingNetwork::stats()
+{
+	tpacket_stats_v3 st;
+	socklen_t n = sizeof(st);
+	if (fd_ < 0 ||
+	    getsockopt(fd_, SOL_PACKET, PACKET_STATISTICS, &st, &n) < 0)
+		return;
+	pkts_ += st.tp_packets;
+	pdrops_ += st.tp_drops;
+}
+
+#endif /* __linux__ && TPACKET3_HDRLEN */
@@ -68,6 +68,8 @@ public:
 	} // callback called for every packet
 	virtual int rchannel() = 0;
 	virtual int schannel() = 0;
+	// # of packets that recv() returns without waiting, if known
+	virtual int pending() { return (0); }
 	int mode() { return mode_; }
 	static int nonblock(int fd);
 	static int parsemode(const char*);  // strings to mode bits
@@ -204,11 +204,15 @@ TapAgent::dispatch(int)
 	 * but instead we allow the dispatcher to call us back
 	 * if there is a queue in the socket buffer; this allows
 	 * other events to get a chance to slip in...
+	 * Networks that receive in batches (Network/Packet/Ring) tell
+	 * us how much of the current batch is left; we take all of it.
 	 */
 #ifdef notdef
 Scheduler::instance().sync();	// sim clock gets set to now
 #endif
 	recvpkt();
+	for (int n = net_->pending(); n > 0; n--)
+		recvpkt();
 }
 
 /*
@@ -52,11 +52,16 @@ public:
 LinkDelay::LinkDelay() 
 	: dynamic_(0), 
 	  latest_time_(0),
-	  itq_(0)
+	  itq_(0),
+	  bgshare_(0),
+	  bgdelay_(0),
+	  bglatest_(0),
+	  txbytes_(0)
 {
 	bind_bw("bandwidth_", &bandwidth_);
 	bind_time("delay_", &delay_);
 	bind_bool("avoidReordering_", &avoidReordering_);
+	bind_bool("batch_", &batch_);
 }
 
 int LinkDelay::command(int argc, const char*const* argv)
@@ -85,26 +90,62 @@ int LinkDelay::command(int argc, const char*const* argv)
 void LinkDelay::recv(Packet* p, Handler* h)
 {
 	double txt = txtime(p);
+	double delay = delay_ + bgdelay_;
 	Scheduler& s = Scheduler::instance();
-	if (dynamic_) {
+
+	if (bgdelay_ != 0 || bglatest_ > s.clock()) {
+		// FluidModel::step() may shrink the backlog between two
+		// packets, but a packet still arrives after the one that
+		// was queued ahead of it
+		double now = s.clock();
+		if (txt + delay < bglatest_ - now)
+			delay = bglatest_ - now - txt;
+		bglatest_ = now + txt + delay;
+	}
+	txbytes_ += hdr_cmn::access(p)->size();
+	if (batch_ && !avoidReordering_) {
+		// Packets in transit wait in itq_, ordered by arrival
+		// time; only the head has an event in the scheduler.
+		// The arrival time is computed exactly as schedule()
+		// would, so packets reach target_ at the same instants.
+		if (itq_ == 0)
+			itq_ = new PacketQueue();
+		p->time_ = s.clock() + (txt + delay);
+		Packet* head = itq_->head();
+		Packet* tail = itq_->tail();
+		if (tail == 0 || tail->time_ <= p->time_) {
+			itq_->enque(p);
+		} else {
+			// bandwidth increased or delay decreased, so p
+			// overtakes packets in transit: insert it after the
+			// last one that arrives no later than p
+			Packet* prev = 0;
+			for (Packet* np = head; np != 0 &&
+			     np->time_ <= p->time_; np = np->next_)
+				prev = np;
+			itq_->enqueAfter(prev, p);
+		}
+		if (itq_->head() != head)
+			schedule_next();
+	} else if (dynamic_) {
 		Event* e = (Event*)p;
-		e->time_= txt + delay_;
+		e->time_= txt + delay;
 		itq_->enque(p); // for convinience, use a queue to store packets in transit
-		s.schedule(this, p, txt + delay_);
+		s.schedule(this, p, txt + delay);
 	} else if (avoidReordering_) {
 		// code from Andrei Gurtov, to prevent reordering on
 		//   bandwidth or delay changes
  		double now_ = Scheduler::instance().clock();
- 		if (txt + delay_ < latest_time_ - now_ && latest_time_ > 0) {
+ 		if (txt + delay < latest_time_ - now_ && latest_time_ > 0) {
  			latest_time_+=txt;
  			s.schedule(target_, p, latest_time_ - now_ );
  		} else {
- 			latest_time_ = now_ + txt + delay_;
- 			s.schedule(target_, p, txt + delay_);
+ 			latest_time_ = now_ + txt + delay;
+ 			s.schedule(target_, p, txt + delay);
  		}
 
 	} else {
-		s.schedule(target_, p, txt + delay_);
+		s.schedule(target_, p, txt + delay);
 	}
 	s.schedule(h, &intr_, txt);
 }
@@ -118,6 +159,8 @@ void LinkDelay::reset()
 {
 	Scheduler& s= Scheduler::instance();
 
+	// batched packets in transit are not scheduled themselves
+	s.cancel(&arrival_);
 	if (itq_ && itq_->length()) {
 		Packet *np;
 		// walk through packets currently in transit and kill 'em
@@ -128,8 +171,39 @@ void LinkDelay::reset()
 	}
 }
 
+void LinkDelay::schedule_next()
+{
+	Scheduler& s = Scheduler::instance();
+	Packet* p = itq_->head();
+
+	s.cancel(&arrival_);
+	if (p != 0)
+		s.schedule(this, &arrival_, p->time_ - s.clock());
+}
+
+void LinkDelay::deliver_due()
+{
+	Scheduler& s = Scheduler::instance();
+	Packet* p;
+
+	// send() may call back into recv() on looped topologies, in
+	// which case arrival_ has already been rescheduled there
+	while ((p = itq_->head()) != 0 && p->time_ <= s.clock()) {
+		itq_->deque();
+		send(p, (Handler*) NULL);
+	}
+	// clock() + (time_ - clock()) may round below time_; we then
+	// simply fire again a few ulps later, so nothing is early
+	if (p != 0 && arrival_.uid_ <= 0)
+		schedule_next();
+}
+
 void LinkDelay::handle(Event* e)
 {
+	if (e == &arrival_) {
+		deliver_due();
+		return;
+	}
 	Packet *p = itq_->deque();
 	assert(p->time_ == e->time_);
 	send(p, (Handler*) NULL);
@@ -52,13 +52,28 @@ class LinkDelay : public Connector {
 	void handle(Event* e);
 	double delay() { return delay_; }
 	inline double txtime(Packet* p) {
-		return (8. * hdr_cmn::access(p)->size() / bandwidth_);
+		return (8. * hdr_cmn::access(p)->size() /
+			(bandwidth_ * (1 - bgshare_)));
 	}
 	double bandwidth() const { return bandwidth_; }
+	/* set the share of the link taken by background fluid traffic */
+	void background(double rate, double delay) {
+		assert(rate < bandwidth_ || rate == 0);
+		bgshare_ = (rate > 0) ? rate / bandwidth_ : 0;
+		bgdelay_ = delay;
+	}
+	/* bytes sent since the last call, for FluidModel */
+	double txbytes() {
+		double b = txbytes_;
+		txbytes_ = 0;
+		return (b);
+	}
 	void pktintran(int src, int group);
  protected:
 	int command(int argc, const char*const* argv);
 	void reset();
+	void schedule_next();	/* schedule arrival_ for the head of itq_ */
+	void deliver_due();	/* deliver all packets in itq_ that are due */
 	double bandwidth_;	/* bandwidth of underlying link (bits/sec) */
 	double delay_;		/* line latency */
 	Event intr_;
@@ -70,6 +85,18 @@ class LinkDelay : public Connector {
 	int avoidReordering_;	/* indicates whether or not to avoid
 				 *  reordering when link bandwidth or delay 
 				 *  changes */
+	int batch_;		/* indicates whether or not packets in
+				 *  transit are held in itq_ and delivered
+				 *  as a train by a single arrival_ event */
+	Event arrival_;		/* arrival of the head of itq_ (batch_) */
+	double bgshare_;	/* fraction of bandwidth_ used by background
+				 *  fluid traffic (see FluidModel), so that
+				 *  txtime() stays finite if bandwidth_
+				 *  changes between two fluid steps */
+	double bgdelay_;	/* queueing delay of the fluid backlog */
+	double bglatest_;	/* latest arrival time while bgdelay_ is
+				 *  in use, to avoid reordering */
+	double txbytes_;	/* bytes sent since txbytes() */
 };
 
 #endif
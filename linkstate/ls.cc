@@ -64,6 +64,8 @@
 #include "config.h"
 #ifdef HAVE_STL
 
+#include <algorithm>
+#include <functional>
 #include "ls.h"
 
 // a global variable
@@ -287,6 +289,343 @@ LsPathsTentative::iterator LsPathsTentative::findMinEqualPaths()
 	return minCostIterator;
 }
 
+/*
+  LsSpf methods
+*/
+
+struct LsSpfEdge {
+	int u, v, w;
+};
+
+static bool lsEdgeLess(const LsSpfEdge& a, const LsSpfEdge& b)
+{
+	if (a.u != b.u) return a.u < b.u;
+	if (a.v != b.v) return a.v < b.v;
+	return a.w < b.w;
+}
+
+// returns false if there's an up link with a non-positive cost
+bool LsSpf::Graph::build(const LsTopoMap& topo)
+{
+	vector<LsSpfEdge> edges;
+	for (LsTopoMap::const_iterator itr = topo.begin(); 
+	     itr != topo.end(); itr++) {
+		int u = (*itr).first;
+		if (u >= n) n = u + 1;
+		for (LsLinkStateList::const_iterator itrLink = 
+			     (*itr).second.begin();
+		     itrLink != (*itr).second.end(); itrLink++) {
+			if ((*itrLink).status_ != LS_STATUS_UP)
+				continue;
+			if ((*itrLink).cost_ <= 0)
+				return false;
+			LsSpfEdge e;
+			e.u = u;
+			e.v = (*itrLink).neighborId_;
+			e.w = (*itrLink).cost_;
+			if (e.v >= n) n = e.v + 1;
+			edges.push_back(e);
+		}
+	}
+	// one edge per node pair, the cheapest
+	sort(edges.begin(), edges.end(), lsEdgeLess);
+	unsigned int m = 0;
+	for (unsigned int i = 0; i < edges.size(); i++)
+		if (m == 0 || edges[i].u != edges[m-1].u || 
+		    edges[i].v != edges[m-1].v)
+			edges[m++] = edges[i];
+
+	off.assign(n + 1, 0);
+	roff.assign(n + 1, 0);
+	dst.resize(m); cost.resize(m);
+	rsrc.resize(m); rcost.resize(m);
+	unsigned int i;
+	for (i = 0; i < m; i++) {
+		off[edges[i].u + 1]++;
+		roff[edges[i].v + 1]++;
+	}
+	for (int u = 0; u < n; u++) {
+		off[u + 1] += off[u];
+		roff[u + 1] += roff[u];
+	}
+	vector<int> pos(roff.begin(), roff.end() - 1);
+	for (i = 0; i < m; i++) {
+		dst[i] = edges[i].v;
+		cost[i] = edges[i].w;
+		rsrc[pos[edges[i].v]] = edges[i].u;
+		rcost[pos[edges[i].v]++] = edges[i].w;
+	}
+	return true;
+}
+
+void LsSpf::Graph::swap(Graph& g)
+{
+	int t = n; n = g.n; g.n = t;
+	off.swap(g.off); dst.swap(g.dst); cost.swap(g.cost);
+	roff.swap(g.roff); rsrc.swap(g.rsrc); rcost.swap(g.rcost);
+}
+
+bool LsSpf::compute(int root, const LsTopoMap& topo)
+{
+	Graph g;
+	g.n = root + 1;
+	if (!g.build(topo)) {
+		valid_ = false;
+		return false;
+	}
+	bool incr = valid_ && (root == root_) && (g.n == n_);
+	old_.swap(graph_);
+	graph_.swap(g);
+	root_ = root;
+	if (incr)
+		incremental();
+	else
+		full();
+	valid_ = true;
+	return true;
+}
+
+void LsSpf::full()
+{
+	n_ = graph_.n;
+	dist_.assign(n_, INF);
+	paths_.assign(n_, LsEqualPaths());
+	mark_.assign(n_, true);
+	head_.assign(n_, false);
+	changes_.clear();
+
+	dist_[root_] = 0;
+	heap_.clear();
+	heap_.push_back(pair<int, int>(0, root_));
+	dijkstra(mark_, false);
+
+	vector<int> nodes;
+	for (int x = 0; x < n_; x++)
+		nodes.push_back(x);
+	nextHops(nodes);
+}
+
+/*
+  The graph of the first pass of incremental(): the old one with only
+  the cost increases (and link failures) applied.
+*/
+int LsSpf::g1weight(int p, int x, int w)
+{
+	if (!head_[x])
+		return w;
+	for (unsigned int i = 0; i < changes_.size(); i++)
+		if (changes_[i].u == p && changes_[i].v == x)
+			return max(changes_[i].wold, changes_[i].wnew);
+	return w;
+}
+
+// Dijkstra from the entries in heap_, over the nodes in 'in' only
+void LsSpf::dijkstra(const vector<bool>& in, bool g1)
+{
+	greater<pair<int, int> > cmp;
+	while (!heap_.empty()) {
+		pop_heap(heap_.begin(), heap_.end(), cmp);
+		int d = heap_.back().first;
+		int x = heap_.back().second;
+		heap_.pop_back();
+		if (d > dist_[x])
+			continue; // stale
+		for (int e = graph_.off[x]; e < graph_.off[x + 1]; e++) {
+			int y = graph_.dst[e];
+			int w = graph_.cost[e];
+			if (!in[y])
+				continue;
+			if (g1 && (w = g1weight(x, y, w)) == INF)
+				continue;
+			if (d + w < dist_[y]) {
+				dist_[y] = d + w;
+				heap_.push_back(pair<int, int>(dist_[y], y));
+				push_heap(heap_.begin(), heap_.end(), cmp);
+			}
+		}
+	}
+}
+
+void LsSpf::incremental()
+{
+	int u, x, e;
+	unsigned int i;
+	greater<pair<int, int> > cmp;
+
+	// the links that changed
+	changes_.clear();
+	head_.assign(n_, false);
+	for (u = 0; u < n_; u++) {
+		int eo = old_.off[u], en = graph_.off[u];
+		while (eo < old_.off[u + 1] || en < graph_.off[u + 1]) {
+			Change c;
+			c.u = u;
+			if (en == graph_.off[u + 1] || (eo < old_.off[u + 1] &&
+			    old_.dst[eo] < graph_.dst[en])) {
+				c.v = old_.dst[eo];
+				c.wold = old_.cost[eo++];
+				c.wnew = INF;
+			} else if (eo == old_.off[u + 1] || 
+				   graph_.dst[en] < old_.dst[eo]) {
+				c.v = graph_.dst[en];
+				c.wold = INF;
+				c.wnew = graph_.cost[en++];
+			} else {
+				c.v = graph_.dst[en];
+				c.wold = old_.cost[eo++];
+				c.wnew = graph_.cost[en++];
+				if (c.wold == c.wnew)
+					continue;
+			}
+			changes_.push_back(c);
+			head_[c.v] = true;
+		}
+	}
+	if (changes_.empty())
+		return;
+	odist_ = dist_;
+
+	// 1. cost increases: recompute the subtrees below the links,
+	// from the distances of the nodes around them
+	vector<int> nodes;
+	mark_.assign(n_, false);
+	for (i = 0; i < changes_.size(); i++) {
+		Change& c = changes_[i];
+		if (c.wnew > c.wold && odist_[c.u] != INF && 
+		    odist_[c.u] + c.wold == odist_[c.v] && !mark_[c.v]) {
+			mark_[c.v] = true;
+			nodes.push_back(c.v);
+		}
+	}
+	for (i = 0; i < nodes.size(); i++) {
+		x = nodes[i];
+		for (e = old_.off[x]; e < old_.off[x + 1]; e++) {
+			int y = old_.dst[e];
+			if (odist_[x] + old_.cost[e] == odist_[y] && !mark_[y]) {
+				mark_[y] = true;
+				nodes.push_back(y);
+			}
+		}
+	}
+	for (i = 0; i < nodes.size(); i++)
+		dist_[nodes[i]] = INF;
+	heap_.clear();
+	for (i = 0; i < nodes.size(); i++) {
+		x = nodes[i];
+		for (e = graph_.roff[x]; e < graph_.roff[x + 1]; e++) {
+			int p = graph_.rsrc[e];
+			int w = g1weight(p, x, graph_.rcost[e]);
+			if (mark_[p] || dist_[p] == INF || w == INF)
+				continue;
+			if (dist_[p] + w < dist_[x])
+				dist_[x] = dist_[p] + w;
+		}
+		if (dist_[x] != INF)
+			heap_.push_back(pair<int, int>(dist_[x], x));
+	}
+	make_heap(heap_.begin(), heap_.end(), cmp);
+	dijkstra(mark_, true);
+
+	// 2. cost decreases (and new links): propagate the improvements
+	heap_.clear();
+	for (i = 0; i < changes_.size(); i++) {
+		Change& c = changes_[i];
+		if (c.wnew < c.wold && dist_[c.u] != INF && 
+		    dist_[c.u] + c.wnew < dist_[c.v]) {
+			dist_[c.v] = dist_[c.u] + c.wnew;
+			heap_.push_back(pair<int, int>(dist_[c.v], c.v));
+		}
+	}
+	make_heap(heap_.begin(), heap_.end(), cmp);
+	mark_.assign(n_, true);
+	dijkstra(mark_, false);
+
+	// 3. next hops: the nodes whose distance changed or that have a 
+	// changed link, and everything below them in the old or the new
+	// shortest path graph
+	nodes.clear();
+	mark_.assign(n_, false);
+	for (x = 0; x < n_; x++)
+		if (dist_[x] != odist_[x] || head_[x]) {
+			mark_[x] = true;
+			nodes.push_back(x);
+		}
+	for (i = 0; i < nodes.size(); i++) {
+		x = nodes[i];
+		for (e = old_.off[x]; odist_[x] != INF && e < old_.off[x + 1]; 
+		     e++) {
+			int y = old_.dst[e];
+			if (odist_[x] + old_.cost[e] == odist_[y] && !mark_[y]) {
+				mark_[y] = true;
+				nodes.push_back(y);
+			}
+		}
+		for (e = graph_.off[x]; dist_[x] != INF && 
+			     e < graph_.off[x + 1]; e++) {
+			int y = graph_.dst[e];
+			if (dist_[x] + graph_.cost[e] == dist_[y] && !mark_[y]) {
+				mark_[y] = true;
+				nodes.push_back(y);
+			}
+		}
+	}
+	nextHops(nodes);
+}
+
+struct LsSpfByDist {
+	const vector<int>& dist;
+	LsSpfByDist(const vector<int>& d) : dist(d) {}
+	bool operator() (int a, int b) const {
+		if (dist[a] != dist[b]) return dist[a] < dist[b];
+		return a < b;
+	}
+};
+
+/*
+  Rebuild the next hop lists of nodes.  _computeRoutes() expands the
+  nodes in (cost, id) order and appends the next hops of each parent
+  on a shortest path, without duplicates, so do the same.
+*/
+void LsSpf::nextHops(vector<int>& nodes)
+{
+	LsSpfByDist byDist(dist_);
+	sort(nodes.begin(), nodes.end(), byDist);
+
+	vector<int> parents;
+	for (unsigned int i = 0; i < nodes.size(); i++) {
+		int x = nodes[i];
+		LsEqualPaths& ep = paths_[x];
+		ep.nextHopList.eraseAll();
+		if (dist_[x] == INF) {
+			ep.cost = LS_INVALID_COST;
+			continue;
+		}
+		ep.cost = dist_[x];
+		if (x == root_) {
+			ep.nextHopList.push_back(root_);
+			continue;
+		}
+		parents.clear();
+		for (int e = graph_.roff[x]; e < graph_.roff[x + 1]; e++) {
+			int p = graph_.rsrc[e];
+			if (dist_[p] != INF && dist_[p] + graph_.rcost[e] == 
+			    dist_[x])
+				parents.push_back(p);
+		}
+		sort(parents.begin(), parents.end(), byDist);
+		for (unsigned int j = 0; j < parents.size(); j++) {
+			if (parents[j] == root_) {
+				// directly connected, nextHop is itself
+				LsNodeIdList self;
+				self.push_back(x);
+				ep.appendNextHopList(self);
+			} else
+				ep.appendNextHopList(
+					paths_[parents[j]].nextHopList);
+		}
+	}
+}
+
 /*
   LsMessageCenter methods
 */
@@ -933,4 +1272,31 @@ LsPaths* LsRouting::_computeRoutes ()
 	return pPaths;
 }
 
+int LsRouting::checkRoutes()
+{
+	LsPaths* pPaths = _computeRoutes();
+	int maxId = myNodeId_;
+	for (LsTopoMap::iterator itr = linkStateDatabase_.begin();
+	     itr != linkStateDatabase_.end(); itr++) {
+		if ((*itr).first > maxId)
+			maxId = (*itr).first;
+		for (LsLinkStateList::iterator itrLink = (*itr).second.begin();
+		     itrLink != (*itr).second.end(); itrLink++)
+			if ((*itrLink).neighborId_ > maxId)
+				maxId = (*itrLink).neighborId_;
+	}
+	int bad = 0;
+	for (int id = 0; id <= maxId; id++) {
+		LsEqualPaths* p = lookup(id);
+		LsEqualPaths* q = pPaths->findPtr(id);
+		if (p == NULL && q == NULL)
+			continue;
+		if (p == NULL || q == NULL || p->cost != q->cost ||
+		    p->nextHopList != q->nextHopList)
+			bad++;
+	}
+	delete pPaths;
+	return bad;
+}
+
 #endif //HAVE_STL
@@ -67,6 +67,7 @@
 #include <sys/types.h> 
 #include <list>
 #include <map>
+#include <vector>
 #include <utility>
 
 #include "timer-handler.h"
@@ -343,6 +344,70 @@ private:
 	iterator findMinEqualPaths();
 };
 
+/*
+  LsSpf -- shortest paths of LsRouting over flat arrays indexed by
+  node id, with incremental recomputation.
+
+  Each compute() takes a snapshot of the link state database as
+  adjacency arrays and compares it with the previous one.  Only the
+  nodes whose distance or equal cost next hops can have changed, i.e.
+  the shortest path subtrees below the links whose cost or status
+  changed, are recomputed.  Next hop lists come out in the same order
+  as from LsRouting::_computeRoutes(), which is still used when some
+  link has a non-positive cost.
+*/
+class LsSpf {
+public:
+	LsSpf() : root_(LS_INVALID_NODE_ID), n_(0), valid_(false) {}
+
+	// returns false, and invalidates the paths, if topo can't be
+	// handled here
+	bool compute(int root, const LsTopoMap& topo);
+	void invalidate() { valid_ = false; }
+	bool valid() { return valid_; }
+	LsEqualPaths* lookup(int destId) {
+		// no route costs more than this
+		if (!valid_ || destId < 0 || destId >= n_ || 
+		    dist_[destId] > LS_MAX_COST)
+			return (LsEqualPaths *)NULL;
+		return &paths_[destId];
+	}
+
+private:
+	enum { INF = 0x3fffffff };
+
+	// adjacency arrays, out edges sorted by destination, one per
+	// node pair with the lowest cost of the up links
+	struct Graph {
+		int n;
+		vector<int> off, dst, cost;	// out edges
+		vector<int> roff, rsrc, rcost;	// in edges
+		bool build(const LsTopoMap& topo);
+		void swap(Graph& g);
+	};
+
+	struct Change {
+		int u, v;
+		int wold, wnew;
+	};
+
+	void full();
+	void incremental();
+	int g1weight(int p, int x, int w);
+	void dijkstra(const vector<bool>& in, bool g1);
+	void nextHops(vector<int>& nodes);
+
+	int root_;
+	int n_;
+	bool valid_;
+	Graph graph_, old_;
+	vector<int> dist_, odist_;
+	vector<LsEqualPaths> paths_;
+	vector<Change> changes_;
+	vector<bool> mark_, head_;
+	vector<pair<int, int> > heap_;
+};
+
 /* 
    LsMessage 
 */
@@ -581,13 +646,20 @@ public:
 	void computeRoutes() {
 	        if (routingTablePtr_ != NULL)
 	                delete routingTablePtr_;
-	        routingTablePtr_ = _computeRoutes();
+	        routingTablePtr_ = NULL;
+	        if (!spf_.compute(myNodeId_, linkStateDatabase_))
+	                routingTablePtr_ = _computeRoutes();
 	}
 	LsEqualPaths* lookup(int destId) {
+		if (spf_.valid())
+			return spf_.lookup(destId);
 		return (routingTablePtr_ == NULL) ? 
 			(LsEqualPaths *)NULL : 
 			routingTablePtr_->findPtr(destId);
 	}
+	// number of destinations where lookup() differs from 
+	// _computeRoutes(), for validation
+	int checkRoutes();
 
 	// to propogate LSA, all Links, called by node and self
 	bool sendLinkStates(bool buffer = false); 
@@ -605,7 +677,8 @@ private:
 	LsNodeIdList* peerIdListPtr_; // my peers
 	LsLinkStateList* linkStateListPtr_; // My links
 	LsMessageCenter* messageCenterPtr_; // points to static messageCenter
-	LsPaths* routingTablePtr_; // the routing table
+	LsPaths* routingTablePtr_; // the routing table, if not from spf_
+	LsSpf spf_; // the routing table
 	LsTopoMap linkStateDatabase_; // topology;
 	LsMessageHistory lsaHistory_; // Remember what we've seen
 	LsMessageHistory tpmHistory_; 
@@ -144,6 +144,10 @@ int rtProtoLS::command(int argc, const char*const* argv)
 		computeRoutes();
 		return TCL_OK;
 	}
+	if (strcmp(argv[1], "checkRoutes") == 0) {
+		Tcl::instance().resultf("%d", routing_.checkRoutes());
+		return TCL_OK;
+	}
 	if (strcmp(argv[1], "intfChanged") == 0) {
 		intfChanged();
 		return TCL_OK;
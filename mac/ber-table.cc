@@ -0,0 +1,108 @@
+/* -*-	Mode:C++; c-basic-offset:8; tab-width:8; indent-tabs-mode:t -*- */
+/*
+ * Bit error rate versus SINR curves for the SINR receiver model of
+ * WirelessPhy.  See ber-table.h.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "ber-table.h"
+
+static class BerTableClass : public TclClass {
+public:
+	BerTableClass() : TclClass("BerTable") {}
+	TclObject* create(int, const char*const*) {
+		return (new BerTable);
+	}
+} class_ber_table;
+
+BerTable::BerTable() : ncurves_(0)
+{
+}
+
+BerTable::~BerTable()
+{
+	for (int i = 0; i < ncurves_; i++)
+		delete [] curve_[i].ber;
+}
+
+/*
+ * $ber add <rate> <sinr_db> <ber> ?<sinr_db> <ber> ...?
+ * Points must be given in increasing SINR order.
+ */
+int BerTable::command(int argc, const char*const* argv)
+{
+	Tcl& tcl = Tcl::instance();
+	if (argc >= 6 && strcmp(argv[1], "add") == 0) {
+		if (ncurves_ == BER_TABLE_MAXCURVES) {
+			tcl.resultf("%s: too many curves", name());
+			return (TCL_ERROR);
+		}
+		if ((argc - 3) % 2 != 0) {
+			tcl.resultf("%s: odd number of (sinr, ber) values",
+				    name());
+			return (TCL_ERROR);
+		}
+		int npts = (argc - 3) / 2;
+		double* db = new double[npts];
+		double* lb = new double[npts];
+		for (int i = 0; i < npts; i++) {
+			double b = atof(argv[4 + 2 * i]);
+			if (b < BER_TABLE_MINBER)
+				b = BER_TABLE_MINBER;
+			db[i] = atof(argv[3 + 2 * i]);
+			lb[i] = log10(b);
+			if (i > 0 && db[i] <= db[i - 1]) {
+				delete [] db;
+				delete [] lb;
+				tcl.resultf("%s: sinr values not increasing",
+					    name());
+				return (TCL_ERROR);
+			}
+		}
+		Curve& c = curve_[ncurves_++];
+		c.rate = atof(argv[2]);
+		c.snr0 = db[0];
+		c.n = int((db[npts - 1] - db[0]) / BER_TABLE_STEP) + 1;
+		c.ber = new double[c.n];
+		int k = 0;
+		for (int i = 0; i < c.n; i++) {
+			double x = c.snr0 + i * BER_TABLE_STEP;
+			while (k < npts - 2 && x > db[k + 1])
+				k++;
+			double f = (x - db[k]) / (db[k + 1] - db[k]);
+			c.ber[i] = pow(10, lb[k] + f * (lb[k + 1] - lb[k]));
+		}
+		delete [] db;
+		delete [] lb;
+		return (TCL_OK);
+	}
+	return (TclObject::command(argc, argv));
+}
+
+double BerTable::ber(double rate, double sinr)
+{
+	if (ncurves_ == 0)
+		return (0);
+	// the curve of the nearest modulation
+	Curve* c = &curve_[0];
+	for (int i = 1; i < ncurves_; i++)
+		if (fabs(curve_[i].rate - rate) < fabs(c->rate - rate))
+			c = &curve_[i];
+	if (sinr <= 0)
+		return (c->ber[0]);
+	int i = int((10 * log10(sinr) - c->snr0) / BER_TABLE_STEP + 0.5);
+	if (i < 0)
+		i = 0;
+	if (i >= c->n)
+		i = c->n - 1;
+	return (c->ber[i]);
+}
+
+double BerTable::per(double rate, double sinr, int bytes)
+{
+	double b = ber(rate, sinr);
+	if (b <= 0)
+		return (0);
+	return (1 - pow(1 - b, 8. * bytes));
+}
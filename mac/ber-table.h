@@ -0,0 +1,47 @@
+/* -*-	Mode:C++; c-basic-offset:8; tab-width:8; indent-tabs-mode:t -*- */
+/*
+ * Bit error rate versus SINR curves, one per modulation (identified by
+ * its data rate), for the SINR receiver model of WirelessPhy.
+ *
+ * Curves are given in Tcl as (SINR in dB, BER) points:
+ *
+ *	set ber [new BerTable]
+ *	$ber add 11e6  4.0 1e-2  6.0 1e-4  8.0 1e-6  10.0 1e-8
+ *	$phy ber-table $ber
+ *
+ * and resampled, log-linearly, onto a uniform BER_TABLE_STEP grid so
+ * that a lookup is a single index computation.  One BerTable is
+ * normally shared by all the WirelessPhy objects of a simulation.
+ */
+
+#ifndef ns_ber_table_h
+#define ns_ber_table_h
+
+#include "config.h"
+
+#define BER_TABLE_STEP		0.1	/* grid resolution (dB) */
+#define BER_TABLE_MAXCURVES	8
+#define BER_TABLE_MINBER	1e-30	/* smaller BERs are taken as this */
+
+class BerTable : public TclObject {
+public:
+	BerTable();
+	~BerTable();
+	/* BER of a frame sent at rate (bits/s) received at the given
+	 * (linear) SINR */
+	double ber(double rate, double sinr);
+	/* probability that a frame of the given size has an error */
+	double per(double rate, double sinr, int bytes);
+protected:
+	int command(int argc, const char*const* argv);
+
+	struct Curve {
+		double rate;		/* data rate of the modulation */
+		double snr0;		/* SINR of ber[0] (dB) */
+		int n;
+		double* ber;
+	} curve_[BER_TABLE_MAXCURVES];
+	int ncurves_;
+};
+
+#endif
@@ -287,7 +287,22 @@ double WirelessChannel::highestAntennaZ_ = -1; // i.e., uninitialized
 double WirelessChannel::distCST_ = -1;
 
 WirelessChannel::WirelessChannel(void) : Channel(), numNodes_(0), 
-					 xListHead_(NULL), sorted_(0) {}
+					 xListHead_(NULL), sorted_(0),
+					 scratch_(NULL), nscratch_(0),
+					 nbr_(NULL), nnbr_(0), gen_(0)
+{
+	bind_bool("linkCache_", &linkCache_);
+}
+
+WirelessChannel::~WirelessChannel()
+{
+	for (int i = 0; i < nnbr_; i++) {
+		delete [] nbr_[i].nodes;
+		delete [] nbr_[i].pdelay;
+	}
+	delete [] nbr_;
+	delete [] scratch_;
+}
 
 int WirelessChannel::command(int argc, const char*const* argv)
 {
@@ -338,13 +353,13 @@ WirelessChannel::sendUp(Packet* p, Phy *tifp)
 	    GridKeeper* gk = GridKeeper::instance();
 	    int size = gk->size_; 
 	    
-	    MobileNode **outlist = new MobileNode *[size];
+	    MobileNode **outlist = scratch(size);
 	 
        	    int out_index = gk->get_neighbors((MobileNode*)tnode,
 						         outlist);
 	    for (i=0; i < out_index; i ++) {
 		
-		  newp = p->copy();
+		  newp = p->copy_shared();
 		  rnode = outlist[i];
 		  propdelay = get_pdelay(tnode, rnode);
 
@@ -356,8 +371,17 @@ WirelessChannel::sendUp(Packet* p, Phy *tifp)
 			  }
 		  }
  	    }
-	    delete [] outlist; 
 	 
+	 } else if (linkCache_ && MobileNode::moving() == 0) {
+		 // same receivers, in the same order, as below
+		 NbrCache *c = neighbors((MobileNode *) tnode);
+		 for (int i = 0; i < c->n; i++) {
+			 newp = p->copy_shared();
+			 rifp = (c->nodes[i]->ifhead()).lh_first;
+			 for(; rifp; rifp = rifp->nextnode()){
+				 s.schedule(rifp, newp, c->pdelay[i]);
+			 }
+		 }
 	 } else { // use list-based improvement
 	 
 		 MobileNode *mtnode = (MobileNode *) tnode;
@@ -375,7 +399,7 @@ WirelessChannel::sendUp(Packet* p, Phy *tifp)
 			 if(rnode == tnode)
 				 continue;
 			 
-			 newp = p->copy();
+			 newp = p->copy_shared();
 			 
 			 propdelay = get_pdelay(tnode, rnode);
 			 
@@ -384,11 +408,51 @@ WirelessChannel::sendUp(Packet* p, Phy *tifp)
 				 s.schedule(rifp, newp, propdelay);
 			 }
 		 }
-		 delete [] affectedNodes;
 	 }
 	 Packet::free(p);
 }
 
+WirelessChannel::NbrCache *
+WirelessChannel::neighbors(MobileNode *mn)
+{
+	int id = mn->nodeid();
+	if (id >= nnbr_) {
+		int n = (2 * nnbr_ > id) ? 2 * nnbr_ : id + 1;
+		NbrCache *nc = new NbrCache[n];
+		memset(nc, 0, n * sizeof(NbrCache));
+		if (nbr_) {
+			memcpy(nc, nbr_, nnbr_ * sizeof(NbrCache));
+			delete [] nbr_;
+		}
+		nbr_ = nc;
+		nnbr_ = n;
+	}
+	NbrCache *c = &nbr_[id];
+	if (c->nodes != NULL && c->moved == MobileNode::moved() &&
+	    c->gen == gen_)
+		return c;
+
+	if(!sorted_){
+		sortLists();
+	}
+	int n = -1;
+	MobileNode **affectedNodes = getAffectedNodes(mn, distCST_ + /* safety */ 5, &n);
+	delete [] c->nodes;
+	delete [] c->pdelay;
+	c->n = 0;
+	c->nodes = new MobileNode *[n > 0 ? n : 1];
+	c->pdelay = new double[n > 0 ? n : 1];
+	for (int i = 0; i < n; i++) {
+		if (affectedNodes[i] == mn)
+			continue;
+		c->nodes[c->n] = affectedNodes[i];
+		c->pdelay[c->n++] = get_pdelay(mn, affectedNodes[i]);
+	}
+	c->moved = MobileNode::moved();
+	c->gen = gen_;
+	return c;
+}
+
 
 void
 WirelessChannel::addNodeToList(MobileNode *mn)
@@ -408,6 +472,7 @@ WirelessChannel::addNodeToList(MobileNode *mn)
 		mn->nextX_ = NULL;
 	}
 	numNodes_++;
+	gen_++;
 }
 
 void
@@ -428,6 +493,7 @@ WirelessChannel::removeNodeFromList(MobileNode *mn) {
 				tmp->nextX_->prevX_ = tmp->prevX_;
 			}
 			numNodes_--;
+			gen_++;
 			return;
 		}
 	}
@@ -564,7 +630,7 @@ WirelessChannel::getAffectedNodes(MobileNode *mn, double radius,
 {
 	double xmin, xmax, ymin, ymax;
 	int n = 0;
-	MobileNode *tmp, **list, **tmpList;
+	MobileNode *tmp, **tmpList;
 
 	if (xListHead_ == NULL) {
 		*numAffectedNodes=-1;
@@ -577,8 +643,8 @@ WirelessChannel::getAffectedNodes(MobileNode *mn, double radius,
 	ymin = mn->Y() - radius;
 	ymax = mn->Y() + radius;
 	
-	// First allocate as much as possibly needed
-	tmpList = new MobileNode*[numNodes_];
+	// As much as possibly needed
+	tmpList = scratch(numNodes_);
 	
 	for(tmp = xListHead_; tmp != NULL; tmp = tmp->nextX_) tmpList[n++] = tmp;
 	for(int i = 0; i < n; ++i)
@@ -597,12 +663,24 @@ WirelessChannel::getAffectedNodes(MobileNode *mn, double radius,
 		}
 	}
 	
-	list = new MobileNode*[n];
-	memcpy(list, tmpList, n * sizeof(MobileNode *));
-	delete [] tmpList;
-         
 	*numAffectedNodes = n;
-	return list;
+	return tmpList;
+}
+
+/*
+ * A buffer of at least n node pointers.  The lists of receivers
+ * returned by getAffectedNodes() and filled in by the GridKeeper live
+ * here, and are only valid until the next transmission.
+ */
+MobileNode **
+WirelessChannel::scratch(int n)
+{
+	if (n > nscratch_) {
+		delete [] scratch_;
+		nscratch_ = (2 * nscratch_ > n) ? 2 * nscratch_ : n;
+		scratch_ = new MobileNode *[nscratch_];
+	}
+	return scratch_;
 }
  
 
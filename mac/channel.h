@@ -106,6 +106,7 @@ class WirelessChannel : public Channel{
 	friend class Topography;
 public:
 	WirelessChannel(void);
+	~WirelessChannel();
 	virtual int command(int argc, const char*const* argv);
         inline double gethighestAntennaZ() { return highestAntennaZ_; }
 
@@ -123,6 +124,29 @@ private:
 	void sortLists(void);
 	void updateNodesList(class MobileNode *mn, double oldX);
 	MobileNode **getAffectedNodes(MobileNode *mn, double radius, int *numAffectedNodes);
+	/* scratch list of receivers, reused by every transmission */
+	MobileNode **scratch(int n);
+	MobileNode **scratch_;
+	int nscratch_;
+
+	/*
+	 * Link cache: while no node moves, the receivers of a
+	 * transmitter and their propagation delays stay the same, so
+	 * they are kept per transmitter (indexed by node id) until
+	 * MobileNode::moved() or the node list changes.
+	 */
+	struct NbrCache {
+		unsigned int moved;
+		int gen;
+		int n;
+		MobileNode **nodes;
+		double *pdelay;
+	};
+	NbrCache *neighbors(MobileNode *mn);
+	int linkCache_;
+	NbrCache *nbr_;
+	int nnbr_;
+	int gen_;
 	
 protected:
 	static double distCST_;        
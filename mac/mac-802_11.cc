@@ -194,6 +194,7 @@ Mac802_11::Mac802_11() :
 	maxSendTime_(0.0),	minSendTime_(10000.0),	avgSendTime_(0.0)
 {
 	bind("CALLRT_", &callRoutelayer);
+	bind_bool("analyticBackoff_", &analyticBackoff_);
 	
 	nav_ = 0.0;
 	tx_state_ = rx_state_ = MAC_IDLE;
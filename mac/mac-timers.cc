@@ -212,6 +212,26 @@ IFTimer::handle(Event *)
 void
 BackoffTimer::handle(Event *)
 {
+	/*
+	 * With the analytic backoff, pause() and resume() only update
+	 * stime, rtime and difs_wait.  Busy periods can only push the
+	 * expiry later, so intr may fire early: either the medium is
+	 * busy now and resume() will schedule the expiry, or intr is
+	 * moved to the expiry computed from the idle time seen so far.
+	 */
+	pending_ = 0;
+	if (lazy_) {
+		Scheduler &s = Scheduler::instance();
+
+		if (paused_)
+			return;
+		double t = stime + (rtime + difs_wait);
+		if (t > s.clock()) {
+			s.schedule(this, &intr, t - s.clock());
+			pending_ = 1;
+			return;
+		}
+	}
 	busy_ = 0;
 	paused_ = 0;
 	stime = 0.0;
@@ -230,7 +250,9 @@ BackoffTimer::start(int cw, int idle)
 
 	busy_ = 1;
 	paused_ = 0;
+	pending_ = 0;
 	stime = s.clock();
+	lazy_ = mac->analyticBackoff_;
 	
 	rtime = (Random::random() % cw) * mac->phymib_.getSlotTime();
 
@@ -246,6 +268,7 @@ BackoffTimer::start(int cw, int idle)
 	else {
 		assert(rtime >= 0.0);
 		s.schedule(this, &intr, rtime);
+		pending_ = 1;
 	}
 }
 
@@ -279,7 +302,10 @@ BackoffTimer::pause()
 
 	difs_wait = 0.0;
 
-	s.cancel(&intr);
+	if (! lazy_) {
+		s.cancel(&intr);
+		pending_ = 0;
+	}
 }
 
 
@@ -304,7 +330,10 @@ BackoffTimer::resume(double difs)
 #endif
 	*/
 	assert(rtime + difs_wait >= 0.0);
+	if (lazy_ && pending_)
+		return;
        	s.schedule(this, &intr, rtime + difs_wait);
+	pending_ = 1;
 }
 
 
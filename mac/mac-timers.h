@@ -72,7 +72,8 @@ protected:
 
 class BackoffTimer : public MacTimer {
 public:
-	BackoffTimer(Mac802_11 *m) : MacTimer(m), difs_wait(0.0) {}
+	BackoffTimer(Mac802_11 *m) : MacTimer(m), difs_wait(0.0),
+		lazy_(0), pending_(0) {}
 
 
 
@@ -82,6 +83,9 @@ public:
 	void	resume(double difs);
 private:
 	double	difs_wait;
+	int	lazy_;		// analytic backoff: intr stays in the
+				// scheduler across busy periods
+	int	pending_;	// intr is in the scheduler
 };
 
 class DeferTimer : public MacTimer {
@@ -48,6 +48,7 @@
 #include <modulation.h>
 #include <omni-antenna.h>
 #include <wireless-phy.h>
+#include <random.h>
 #include <packet.h>
 #include <ip.h>
 #include <agent.h>
@@ -98,9 +99,29 @@ WirelessPhy::WirelessPhy() : Phy(), sleep_timer_(this), status_(IDLE)
 	bind("Pt_", &Pt_);
 	bind("freq_", &freq_);
 	bind("L_", &L_);
+	bind_bool("sinr_", &sinr_);
+	bind("SINRThresh_", &SINRThresh_);
+	bind("noise_", &noise_);
+	bind_time("PLCPTime_", &PLCPTime_);
+	bind_bool("linkCache_", &linkCache_);
 	
 	lambda_ = SPEED_OF_LIGHT / freq_;
 
+	ber_ = 0;
+	ifsum_ = 0;
+	ifn_ = 0;
+	ifmax_ = 16;
+	ifend_ = new double[ifmax_];
+	ifpr_ = new double[ifmax_];
+	lockp_ = 0;
+	lockpuid_ = 0;
+	lockuid_ = 0;
+	lockpr_ = 0;
+	lockend_ = 0;
+	lc_ = 0;
+	lcsize_ = 0;
+	lcn_ = 0;
+
 	node_ = 0;
 	ant_ = 0;
 	propagation_ = 0;
@@ -130,6 +151,13 @@ WirelessPhy::WirelessPhy() : Phy(), sleep_timer_(this), status_(IDLE)
 
 }
 
+WirelessPhy::~WirelessPhy()
+{
+	delete [] ifend_;
+	delete [] ifpr_;
+	delete [] lc_;
+}
+
 int
 WirelessPhy::command(int argc, const char*const* argv)
 {
@@ -191,6 +219,9 @@ WirelessPhy::command(int argc, const char*const* argv)
 			assert(node_ == 0);
 			node_ = (Node *)obj;
 			return TCL_OK;
+		} else if (strcmp(argv[1], "ber-table") == 0) {
+			ber_ = (BerTable*) obj;
+			return TCL_OK;
 		}
 	}
 	return Phy::command(argc,argv);
@@ -312,6 +343,7 @@ WirelessPhy::sendUp(Packet *p)
 
 	PacketStamp s;
 	double Pr;
+	double cp = CPThresh_;
 	int pkt_recvd = 0;
 
 	Pr = p->txinfo_.getTxPr();
@@ -339,7 +371,12 @@ WirelessPhy::sendUp(Packet *p)
 
 	if(propagation_) {
 		s.stamp((MobileNode*)node(), ant_, 0, lambda_);
-		Pr = propagation_->Pr(&p->txinfo_, &s, this);
+		if (linkCache_ && propagation_->deterministic())
+			Pr = cachedPr(p, &s);
+		else
+			Pr = propagation_->Pr(&p->txinfo_, &s, this);
+		if (sinr_)
+			cp = sinr(p, Pr);
 		if (Pr < CSThresh_) {
 			pkt_recvd = 0;
 			goto DONE;
@@ -380,7 +417,7 @@ DONE:
 	   capture.  This will be moved into the net-if family of 
 	   objects in the future. */
 	p->txinfo_.RxPr = Pr;
-	p->txinfo_.CPThresh = CPThresh_;
+	p->txinfo_.CPThresh = cp;
 
 	/*
 	 * Decrease energy if packet successfully received
@@ -554,6 +591,184 @@ void WirelessPhy::UpdateIdleEnergy()
 //	idle_timer_.resched(10.0);
 }
 
+WirelessPhy::LinkCache *
+WirelessPhy::lc_lookup(MobileNode *tx)
+{
+	unsigned int h = (unsigned int) tx->nodeid() * 2654435761U;
+	int i = h & (lcsize_ - 1);
+
+	while (lc_[i].tx != 0 && lc_[i].tx != tx)
+		i = (i + 1) & (lcsize_ - 1);
+	return (&lc_[i]);
+}
+
+/*
+ * Received power of p, from the link cache if the geometry and the
+ * antennas are the same as the last time.  Positions are brought up to
+ * date first, as getLoc() would do.
+ */
+double
+WirelessPhy::cachedPr(Packet *p, PacketStamp *s)
+{
+	MobileNode *tx = p->txinfo_.getNode();
+	MobileNode *rx = (MobileNode *) node();
+	Antenna *ta = p->txinfo_.getAntenna();
+	double lambda = p->txinfo_.getLambda();
+
+	tx->update_position();
+	rx->update_position();
+	double Zt = tx->Z() + ta->getZ();
+	double dX = rx->X() + ant_->getX() - (tx->X() + ta->getX());
+	double dY = rx->Y() + ant_->getY() - (tx->Y() + ta->getY());
+	double dZ = rx->Z() + ant_->getZ() - Zt;
+	// the propagation models use our wavelength for the gains
+	double Gt = ta->getTxGain(dX, dY, dZ, lambda_);
+	double Gr = ant_->getRxGain(dX, dY, dZ, lambda_);
+
+	if (2 * (lcn_ + 1) > lcsize_) {
+		LinkCache *old = lc_;
+		int n = lcsize_;
+		lcsize_ = n ? 2 * n : 16;
+		lc_ = new LinkCache[lcsize_];
+		memset(lc_, 0, lcsize_ * sizeof(LinkCache));
+		for (int i = 0; i < n; i++)
+			if (old[i].tx != 0)
+				*lc_lookup(old[i].tx) = old[i];
+		delete [] old;
+	}
+	LinkCache *e = lc_lookup(tx);
+	if (e->tx == tx && e->dX == dX && e->dY == dY && e->dZ == dZ &&
+	    e->Zt == Zt && e->Gt == Gt && e->Gr == Gr && e->L == L_ &&
+	    e->Pt == p->txinfo_.getTxPr() && e->lambda == lambda)
+		return (e->Pr);
+
+	if (e->tx == 0)
+		lcn_++;
+	e->tx = tx;
+	e->dX = dX;
+	e->dY = dY;
+	e->dZ = dZ;
+	e->Zt = Zt;
+	e->Gt = Gt;
+	e->Gr = Gr;
+	e->L = L_;
+	e->Pt = p->txinfo_.getTxPr();
+	e->lambda = lambda;
+	e->Pr = propagation_->Pr(&p->txinfo_, s, this);
+	return (e->Pr);
+}
+
+/*
+ * SINR receiver model.  Account for a frame of power Pr that starts
+ * now and decide whether it can be decoded against the noise floor and
+ * the frames already on the air.
+ *
+ * Mac802_11 decides capture with RxPr(current) / RxPr(new) >= CPThresh
+ * of the new frame; we return the CPThresh that makes this test
+ * equivalent to the frame being received keeping SINRThresh_ once the
+ * new frame is added to the interference.
+ */
+double
+WirelessPhy::sinr(Packet *p, double Pr)
+{
+	hdr_cmn *hdr = HDR_CMN(p);
+	double now = NOW;
+	double cp = CPThresh_;
+
+	if_retire(now);
+	double snr = Pr / (noise_ + ifsum_);
+	if (lockend_ > now) {
+		double others = noise_ + ifsum_ - lockpr_ + Pr;
+		cp = SINRThresh_ * others / Pr;
+		if (lockpr_ < SINRThresh_ * others) {
+			/*
+			 * Lost.  An interferer below CSThresh_ never
+			 * reaches the MAC, so mark the frame itself.  The
+			 * MAC may have freed it already.  A reused Packet
+			 * has another packet uid or, if it is a copy of
+			 * the same frame, has been scheduled again under
+			 * another event uid.
+			 */
+			if (HDR_CMN(lockp_)->uid() == lockpuid_ &&
+			    lockp_->uid_ == lockuid_)
+				HDR_CMN(lockp_)->error() = 1;
+			lockend_ = 0;
+		}
+	} else if (Pr >= CSThresh_) {
+		lockp_ = p;
+		lockpuid_ = hdr->uid();
+		lockuid_ = p->uid_;
+		lockpr_ = Pr;
+		lockend_ = now + hdr->txtime();
+	}
+	if_insert(now + hdr->txtime(), Pr);
+
+	if (snr < SINRThresh_) {
+		hdr->error() = 1;
+	} else if (ber_ && hdr->txtime() > PLCPTime_) {
+		// no payload time left after the preamble means no rate
+		// to look up, so such frames only see the SINR threshold
+		double rate = 8. * hdr->size() / (hdr->txtime() - PLCPTime_);
+		if (Random::uniform() < ber_->per(rate, snr, hdr->size()))
+			hdr->error() = 1;
+	}
+	return (cp);
+}
+
+/* remove the frames that have ended from the interference sum */
+void
+WirelessPhy::if_retire(double now)
+{
+	while (ifn_ > 0 && ifend_[0] <= now) {
+		ifsum_ -= ifpr_[0];
+		// sift the last element down from the root
+		double e = ifend_[--ifn_];
+		double pr = ifpr_[ifn_];
+		int i = 0;
+		for (;;) {
+			int c = 2 * i + 1;
+			if (c >= ifn_)
+				break;
+			if (c + 1 < ifn_ && ifend_[c + 1] < ifend_[c])
+				c++;
+			if (e <= ifend_[c])
+				break;
+			ifend_[i] = ifend_[c];
+			ifpr_[i] = ifpr_[c];
+			i = c;
+		}
+		ifend_[i] = e;
+		ifpr_[i] = pr;
+	}
+	if (ifn_ == 0)
+		ifsum_ = 0;	// don't let rounding errors accumulate
+}
+
+void
+WirelessPhy::if_insert(double end, double Pr)
+{
+	if (ifn_ == ifmax_) {
+		double *e = new double[2 * ifmax_];
+		double *pr = new double[2 * ifmax_];
+		memcpy(e, ifend_, ifn_ * sizeof(double));
+		memcpy(pr, ifpr_, ifn_ * sizeof(double));
+		delete [] ifend_;
+		delete [] ifpr_;
+		ifend_ = e;
+		ifpr_ = pr;
+		ifmax_ *= 2;
+	}
+	int i = ifn_++;
+	while (i > 0 && ifend_[(i - 1) / 2] > end) {
+		ifend_[i] = ifend_[(i - 1) / 2];
+		ifpr_[i] = ifpr_[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	ifend_[i] = end;
+	ifpr_[i] = Pr;
+	ifsum_ += Pr;
+}
+
 double WirelessPhy::getDist(double Pr, double Pt, double Gt, double Gr,
 			    double hr, double ht, double L, double lambda)
 {
@@ -48,6 +48,7 @@
 #include "phy.h"
 #include "mobilenode.h"
 #include "timer-handler.h"
+#include "ber-table.h"
 
 class Phy;
 class Propagation;
@@ -65,6 +66,7 @@ class Sleep_Timer : public TimerHandler {
 class WirelessPhy : public Phy {
 public:
 	WirelessPhy();
+	~WirelessPhy();
 	
 	void sendDown(Packet *p);
 	int sendUp(Packet *p);
@@ -118,6 +120,51 @@ protected:
 	double RXThresh_;	// receive power threshold (W)
 	double CSThresh_;	// carrier sense threshold (W)
 	double CPThresh_;	// capture threshold (db)
+
+	/*
+	 * SINR receiver model: the power of every frame heard is added
+	 * to a running interference sum until the frame ends.  Frames
+	 * on the air are kept in a heap ordered by end time and are
+	 * retired lazily when the next frame arrives.
+	 */
+	int sinr_;		// use the SINR receiver model
+	double SINRThresh_;	// minimum SINR to decode a frame
+	double noise_;		// thermal noise floor (W)
+	double PLCPTime_;	// preamble + PLCP header duration
+	BerTable *ber_;		// BER curves (optional)
+	double ifsum_;		// interference from frames on the air (W)
+	double *ifend_;		// heap of end times of frames on the air
+	double *ifpr_;		//   and their received powers
+	int ifn_;
+	int ifmax_;
+	Packet *lockp_;		// frame being received,
+	int lockpuid_;		//   its packet uid,
+	scheduler_uid_t lockuid_; //   event uid,
+	double lockpr_;		//   power
+	double lockend_;	//   and end time
+
+	/*
+	 * Link cache: received power per transmitter, valid as long as
+	 * everything Propagation::Pr() depends on is the same: the
+	 * vector between the two antennas and the height of the
+	 * transmitting one, the antenna gains along that vector (which
+	 * follow gain settings and orientation), the system loss, the
+	 * transmit power and the wavelength.  Open addressing on node id.
+	 */
+	struct LinkCache {
+		MobileNode *tx;
+		double dX, dY, dZ;
+		double Zt;
+		double Gt, Gr;
+		double L;
+		double Pt;
+		double lambda;
+		double Pr;
+	};
+	int linkCache_;
+	LinkCache *lc_;
+	int lcsize_;		// power of 2
+	int lcn_;
   
 	Antenna *ant_;
 	Propagation *propagation_;	// Propagation Model
@@ -137,6 +184,11 @@ private:
 	}
 	void UpdateIdleEnergy();
 	void UpdateSleepEnergy();
+	double sinr(Packet *p, double Pr);
+	double cachedPr(Packet *p, PacketStamp *s);
+	LinkCache *lc_lookup(MobileNode *tx);
+	void if_retire(double now);
+	void if_insert(double end, double Pr);
 
 	// Convenience method
 	EnergyModel* em() { return node()->energy_model(); }
@@ -57,6 +57,7 @@ protected:
 	virtual int command(int argc, const char*const* argv);
 	int ignore_;
 	int direction_;
+	int shareData_;
 };
 
 static class ReplicatorClass : public TclClass {
@@ -67,10 +68,11 @@ public:
 	}
 } class_replicator;
 
-Replicator::Replicator() : ignore_(0),direction_(0)
+Replicator::Replicator() : ignore_(0),direction_(0),shareData_(1)
 {
 	bind("ignore_", &ignore_);
 	bind_bool("direction_",&direction_);
+	bind_bool("shareData_", &shareData_);
 }
 
 void Replicator::recv(Packet* p, Handler*)
@@ -93,10 +95,12 @@ void Replicator::recv(Packet* p, Handler*)
 			ch->direction() = hdr_cmn::UP; // Up the stack 
 		}
 	}
+	// Unless shareData_ is off, the copies share the packet's user
+	// data; see Packet::copy_shared().
 	for (int i = 0; i < maxslot_; ++i) {
 		NsObject* o = slot_[i];
 		if (o != 0)
-			o->recv(p->copy());
+			o->recv(shareData_ ? p->copy_shared() : p->copy());
 	}
 	/* we know that maxslot is non-null */
 	slot_[maxslot_]->recv(p);
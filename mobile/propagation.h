@@ -76,6 +76,10 @@ public:
   virtual double Pr(PacketStamp *tx, PacketStamp *rx, WirelessPhy *);
   virtual int command(int argc, const char*const* argv);
 
+  // nonzero if Pr() only depends on the positions and the tx and rx
+  // parameters, so WirelessPhy may cache it (see linkCache_)
+  virtual int deterministic() { return 0; }
+
   // get interference distance
   virtual double getDist(double Pr, double Pt, double Gt, double Gr,
 			 double hr, double ht, double L, double lambda);
@@ -102,6 +106,7 @@ class FreeSpace : public Propagation {
 public:
 //	FreeSpace();
 	virtual double Pr(PacketStamp *tx, PacketStamp *rx, WirelessPhy *ifp);
+	virtual int deterministic() { return 1; }
 	virtual double getDist(double Pr, double Pt, double Gt, double Gr,
 			       double ht, double hr, double L, double lambda);
 };
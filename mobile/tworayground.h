@@ -48,6 +48,7 @@ class TwoRayGround : public Propagation {
 public:
   TwoRayGround();
   virtual double Pr(PacketStamp *tx, PacketStamp *rx, WirelessPhy *ifp);
+  virtual int deterministic() { return 1; }
   virtual double getDist(double Pr, double Pt, double Gt, double Gr,
 			 double hr, double ht, double L, double lambda);
 
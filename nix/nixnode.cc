@@ -56,6 +56,8 @@
 
 // STL includes
 #include <vector>
+#include <algorithm>
+#include <pthread.h>
 
 #include "nix/nixnode.h"
 #include "routealgo/bfs.h"
@@ -69,11 +71,31 @@ static Nixl_t NVMin = 0;    // Smallest nv
 static Nixl_t NVMax = 0;    // Largest nv
 static Nixl_t NVTot = 0;    // Total bitcount for all nv's (to compute avg)
 
+// Scratch space for one BFS, reused from one search to the next
+struct NixBFSWork {
+  RoutingVec_t      Parent;
+  vector<char>      Seen;
+  vector<nodeid_t>  Q;
+};
+
+// BFS trees (predecessor vectors) of the most recently used sources,
+// so that the NixVectors of several flows from one source cost a
+// single BFS.  Dropped whenever the topology changes.
+struct NixTree {
+  nodeid_t      src;
+  unsigned long used;   // LRU clock
+  RoutingVec_t  Parent;
+};
+static vector<NixTree> Trees;
+static int             TreeCacheSize = 16;
+static unsigned long   TreeClock = 0;
+static NixBFSWork      Work;     // Workspace of the simulator thread
+
 NixNode::NixNode() : RNode(), m_Map(-1), m_pNixVecs(0)
 {
 	if(0)printf("Hello from NixNode Constructor\n");
   Nodes.push_back(this); // And save it
-
+  Trees.clear();
 }
 
 #ifdef MOVED_TO_NODE
@@ -136,6 +158,7 @@ void NixNode::AddAdj( // Add a new neighbor bit
     }
   pE= new Edge(WhichN);
   m_Adj.push_back(pE);
+  Trees.clear(); // Topology changed
 }
 
 int NixNode::IsNeighbor( // TRUE neighbor bit set
@@ -190,16 +213,74 @@ Edge* pE;
 
 NixVec* NixNode::ComputeNixVector(nodeid_t t)
 { // Compute the NixVector to a target
-RoutingVec_t Parent;
-RoutingVec_t NextHop;
-
   if(0)printf("Computing nixvector from %ld to %ld\n", m_id,  t); 
-  BFS(Nodes, m_id, NextHop, Parent);
+  RoutingVec_t& Parent = GetTree(m_id);
   NixVec* pNv = new NixVec;
   NixRoute(m_id, t, Parent, Nodes, *pNv);
   return pNv;
 }
 
+// Same search as BFS() in routealgo/bfs.cc, and so the same tree, but
+// walks the adjacency vectors directly instead of through NextAdj(),
+// which keeps its position in a static, and only touches w.
+void NixNode::BFS(nodeid_t root, NixBFSWork& w)
+{
+  w.Parent.assign(Nodes.size(), NODE_NONE);
+  w.Seen.assign(Nodes.size(), 0);
+  w.Q.clear();
+  w.Seen[root] = 1;
+  w.Q.push_back(root);
+  for (unsigned long h = 0; h < w.Q.size(); h++)
+    {
+      nodeid_t u = w.Q[h];
+      EdgeVec_t& Adj = ((NixNode*)Nodes[u])->m_Adj;
+      for (EdgeVec_it i = Adj.begin(); i != Adj.end(); i++)
+        {
+          nodeid_t v = (*i)->m_n;
+          if (w.Seen[v]) continue;
+          w.Seen[v] = 1;
+          w.Parent[v] = u;
+          w.Q.push_back(v);
+        }
+    }
+}
+
+RoutingVec_t& NixNode::GetTree(nodeid_t s)
+{ // Get the BFS tree from s, from the cache if possible
+  unsigned long i;
+  for (i = 0; i < Trees.size(); i++)
+    {
+      if (Trees[i].src == s)
+        {
+          Trees[i].used = ++TreeClock;
+          return Trees[i].Parent;
+        }
+    }
+  BFS(s, Work);
+  if (TreeCacheSize <= 0) return Work.Parent;
+  if (Trees.size() < (unsigned long)TreeCacheSize)
+    {
+      Trees.push_back(NixTree());
+      i = Trees.size() - 1;
+    }
+  else
+    { // Replace the least recently used
+      i = 0;
+      for (unsigned long j = 1; j < Trees.size(); j++)
+        if (Trees[j].used < Trees[i].used) i = j;
+    }
+  Trees[i].src = s;
+  Trees[i].used = ++TreeClock;
+  Trees[i].Parent.swap(Work.Parent); // Old vector becomes the workspace
+  return Trees[i].Parent;
+}
+
+void NixNode::SetTreeCache(int n)
+{
+  TreeCacheSize = n;
+  Trees.clear();
+}
+
 NixPair_t NixNode::GetNix(nodeid_t t)  // Get neighbor index/length
 {
   if(0)printf("Node %ld Getnix to target %ld, adjsize %lu\n",
@@ -237,6 +318,37 @@ NsObject* NixNode::GetNsNeighbor(Nix_t n)   // Get the ns nexthop neighbor
   return(m_AdjObj[n]);
 }
 
+void NixNode::AddNixVector(nodeid_t t, NixVec* pNv)
+{
+ // Debug statistics follow
+ if (NVCount == 0)
+	 { // First one
+		 NVMin = pNv->ALth();
+		 NVMax = pNv->ALth();
+	 }
+ else
+	 {
+		 NVMin = (pNv->ALth() < NVMin) ? pNv->ALth() : NVMin;
+		 NVMax = (pNv->ALth() > NVMax) ? pNv->ALth() : NVMax;
+	 }
+ NVCount++;
+ NVTot += pNv->ALth();
+ // End debug stats
+#ifdef TRY_DIFFERENT
+ m_pNixVecs[(const nodeid_t)t] = (const NixVec const *)pNv;
+#else
+ NVPair_t p = NVPair_t(t, pNv);
+                 //const pair <const nodeid_t, NixVec*> p1 = new pair<const nodeid_t, NixVec*>(t,pNv);
+ m_pNixVecs->insert(p);
+#endif
+ pNv->Reset();
+ // debug follows
+#ifdef DEBUG_VERBOSE		
+ printf("Nixvec from %ld to %ld\n", m_id, t);
+ pNv->DBDump();
+#endif
+}
+
 NixVec* NixNode::GetNixVector(nodeid_t t) // Get a nix vector for a target
 {
 NVMap_it i;
@@ -250,39 +362,110 @@ NVMap_it i;
  if (i == m_pNixVecs->end())
 	 { // Does not exist, compute it and add to the hash-map
 		 NixVec* pNv = ComputeNixVector(t);
-		 // Debug statistics follow
-		 if (NVCount == 0)
-			 { // First one
-				 NVMin = pNv->ALth();
-				 NVMax = pNv->ALth();
-			 }
-		 else
-			 {
-				 NVMin = (pNv->ALth() < NVMin) ? pNv->ALth() : NVMin;
-				 NVMax = (pNv->ALth() > NVMax) ? pNv->ALth() : NVMax;
-			 }
-		 NVCount++;
-		 NVTot += pNv->ALth();
-		 // End debug stats
-#ifdef TRY_DIFFERENT
-		 m_pNixVecs[(const nodeid_t)t] = (const NixVec const *)pNv;
-#else
-		 NVPair_t p = NVPair_t(t, pNv);
-                 //const pair <const nodeid_t, NixVec*> p1 = new pair<const nodeid_t, NixVec*>(t,pNv);
-		 m_pNixVecs->insert(p);
-#endif
-		 pNv->Reset();
-		 // debug follows
-#ifdef DEBUG_VERBOSE		
-		 printf("Nixvec from %ld to %ld\n", m_id, t);
-		 pNv->DBDump();
-#endif
+		 AddNixVector(t, pNv);
 		 return(pNv); // Return a the vector
 	 }
  (*i).second->Reset();
  return((*i).second); // Return the vector
 }
 
+// Shared state of the Precompute threads
+struct NixFlows {
+  int              n;
+  const nodeid_t*  src;
+  const nodeid_t*  dst;
+  vector<int>      order;  // Flows sorted by source
+  NixVec**         nv;     // Results, by flow
+  int              next;   // Next entry of order to claim
+  pthread_mutex_t  lock;
+};
+
+void* NixNode::PrecomputeThread(void* arg)
+{ // Take all the flows of one source at a time, with one BFS for them
+NixFlows*  f = (NixFlows*)arg;
+NixBFSWork w;
+
+  while(1)
+    {
+      pthread_mutex_lock(&f->lock);
+      int first = f->next;
+      int last = first;
+      while (last < f->n && f->src[f->order[last]] == f->src[f->order[first]])
+        last++;
+      f->next = last;
+      pthread_mutex_unlock(&f->lock);
+      if (first == f->n) break;
+
+      nodeid_t s = f->src[f->order[first]];
+      BFS(s, w);
+      for (int k = first; k < last; k++)
+        {
+          int j = f->order[k];
+          NixNode* pN = (NixNode*)Nodes[s];
+          if (pN->m_pNixVecs &&
+              pN->m_pNixVecs->find(f->dst[j]) != pN->m_pNixVecs->end())
+            continue; // Already known
+          f->nv[j] = new NixVec;
+          NixRoute(s, f->dst[j], w.Parent, Nodes, *f->nv[j]);
+        }
+    }
+  return 0;
+}
+
+struct NixBySrc {
+  const nodeid_t* src;
+  NixBySrc(const nodeid_t* s) : src(s) { }
+  bool operator()(int a, int b) const { return src[a] < src[b]; }
+};
+
+void NixNode::Precompute(int n, const nodeid_t* src, const nodeid_t* dst,
+                         int nthreads)
+{ // Compute the NixVectors of flows src[i] -> dst[i] ahead of time,
+  // in nthreads threads.  Only the simulator thread changes the nodes.
+NixFlows f;
+int i;
+
+  f.n = 0;
+  f.src = src;
+  f.dst = dst;
+  for (i = 0; i < n; i++)
+    {
+      if (src[i] >= Nodes.size() || dst[i] >= Nodes.size()) continue;
+      f.order.push_back(i);
+      f.n++;
+    }
+  sort(f.order.begin(), f.order.end(), NixBySrc(src));
+  f.nv = new NixVec*[n];
+  for (i = 0; i < n; i++) f.nv[i] = 0;
+  f.next = 0;
+  pthread_mutex_init(&f.lock, 0);
+
+  if (nthreads <= 1)
+    PrecomputeThread(&f);
+  else
+    {
+      pthread_t* tid = new pthread_t[nthreads];
+      for (i = 0; i < nthreads; i++)
+        pthread_create(&tid[i], 0, PrecomputeThread, &f);
+      for (i = 0; i < nthreads; i++)
+        pthread_join(tid[i], 0);
+      delete [] tid;
+    }
+  pthread_mutex_destroy(&f.lock);
+
+  for (i = 0; i < n; i++)
+    {
+      if (!f.nv[i]) continue;
+      NixNode* pN = (NixNode*)Nodes[src[i]];
+      if (!pN->m_pNixVecs) pN->m_pNixVecs = new NVMap_t;
+      if (pN->m_pNixVecs->find(dst[i]) != pN->m_pNixVecs->end())
+        delete f.nv[i]; // Flow given twice
+      else
+        pN->AddNixVector(dst[i], f.nv[i]);
+    }
+  delete [] f.nv;
+}
+
 void NixNode::PopulateObjects(void)
 {
 Edge*      pEdge;
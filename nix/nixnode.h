@@ -29,6 +29,8 @@ typedef map<nodeid_t, NixVec*, less<nodeid_t> > NVMap_t;
 typedef NVMap_t::iterator                       NVMap_it;
 typedef NVMap_t::value_type                     NVPair_t;
 
+struct NixBFSWork;
+
 class NixNode : public RNode {
 public :
 	NixNode();
@@ -47,7 +49,14 @@ public :
 	void    PopulateObjects(void);       // Populate NS NextHop objects
   static NixNode*   GetNodeObject(nodeid_t); // Get a node obj. based on id
   static void       PopulateAllObjects(void);// Populate the next hop objects
+  static void       SetTreeCache(int);       // Max BFS trees kept
+  static void       Precompute(int, const nodeid_t*, const nodeid_t*, int);
+                                             // NixVectors for flows, threaded
 private :
+  void AddNixVector(nodeid_t, NixVec*);      // Add to the known NixVectors
+  static void BFS(nodeid_t, NixBFSWork&);    // Thread safe BFS from a node
+  static RoutingVec_t& GetTree(nodeid_t);    // Cached BFS tree from a node
+  static void* PrecomputeThread(void*);
   EdgeVec_t    m_Adj;             // Adjacent edges
 	ObjVec_t     m_AdjObj;          // NS Objects for adjacencies
   int          m_Map;             // Which system this node is mapped to
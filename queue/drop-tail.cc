@@ -89,8 +89,10 @@ void DropTail::enque(Packet* p)
 	}
 
 	int qlimBytes = qlim_ * mean_pktsize_;
-	if ((!qib_ && (q_->length() + 1) >= qlim_) ||
-  	(qib_ && (q_->byteLength() + hdr_cmn::access(p)->size()) >= qlimBytes)){
+	// bglen_ is the fluid background backlog sharing the buffer
+	if ((!qib_ && (q_->length() + bglen_ + 1) >= qlim_) ||
+  	(qib_ && (q_->byteLength() + bglen_ * mean_pktsize_ +
+		  hdr_cmn::access(p)->size()) >= qlimBytes)){
 		// if the queue would overflow if we added this packet...
 		if (drop_front_) { /* remove from head of queue */
 			q_->enque(p);
@@ -0,0 +1,200 @@
+/* -*-	Mode:C++; c-basic-offset:8; tab-width:8; indent-tabs-mode:t -*- */
+/*
+ * Fluid model of aggregate background TCP traffic on a link.
+ * See fluid-model.h for the equations and the coupling to the
+ * packet-level Queue and LinkDelay objects.
+ *
+ * Usage:
+ *	set fm [new FluidModel]
+ *	$fm set nflows_ 1000
+ *	$fm attach-link [$ns link $n0 $n1]
+ *	$ns at 0.0 "$fm start"
+ */
+
+#include "fluid-model.h"
+
+static class FluidModelClass : public TclClass {
+public:
+	FluidModelClass() : TclClass("FluidModel") {}
+	TclObject* create(int, const char*const*) {
+		return (new FluidModel);
+	}
+} class_fluid_model;
+
+void FluidTimer::expire(Event *)
+{
+	m_->step();
+}
+
+FluidModel::FluidModel() : queue_(0), link_(0), timer_(this),
+	win_(1), qlen_(0), rate_(0), prob_(0),
+	hwin_(0), hprob_(0), hrtt_(0), hsize_(0), hpos_(0)
+{
+	bind("nflows_", &nflows_);
+	bind_time("rtt_", &rtt_);
+	bind("pktsize_", &pktsize_);
+	bind_time("interval_", &interval_);
+	bind("maxwin_", &maxwin_);
+	bind("minth_", &minth_);
+	bind("maxth_", &maxth_);
+	bind("maxp_", &maxp_);
+	bind("win_", &win_);
+	bind("qlen_", &qlen_);
+	bind("rate_", &rate_);
+	bind("prob_", &prob_);
+}
+
+FluidModel::~FluidModel()
+{
+	delete [] hwin_;
+	delete [] hprob_;
+	delete [] hrtt_;
+}
+
+int FluidModel::command(int argc, const char*const* argv)
+{
+	Tcl& tcl = Tcl::instance();
+	if (argc == 2) {
+		if (strcmp(argv[1], "start") == 0) {
+			if (queue_ == 0 || link_ == 0) {
+				tcl.resultf("%s: not attached to a link", name());
+				return (TCL_ERROR);
+			}
+			if (rtt_ <= 0 || interval_ <= 0 || pktsize_ <= 0 ||
+			    nflows_ < 0 || link_->bandwidth() <= 0) {
+				tcl.resultf("%s: rtt_, interval_, pktsize_ and "
+					    "the link bandwidth must be positive",
+					    name());
+				return (TCL_ERROR);
+			}
+			start();
+			return (TCL_OK);
+		}
+		if (strcmp(argv[1], "stop") == 0) {
+			stop();
+			return (TCL_OK);
+		}
+	} else if (argc == 4) {
+		if (strcmp(argv[1], "attach") == 0) {
+			queue_ = (Queue*)TclObject::lookup(argv[2]);
+			if (queue_ == 0) {
+				tcl.resultf("FluidModel: no Queue object %s",
+					    argv[2]);
+				return (TCL_ERROR);
+			}
+			link_ = (LinkDelay*)TclObject::lookup(argv[3]);
+			if (link_ == 0) {
+				tcl.resultf("FluidModel: no LinkDelay object %s",
+					    argv[3]);
+				return (TCL_ERROR);
+			}
+			return (TCL_OK);
+		}
+	}
+	return (TclObject::command(argc, argv));
+}
+
+void FluidModel::start()
+{
+	// The history must reach back one maximum RTT, i.e. the
+	// propagation delay plus a full buffer.
+	double c = link_->bandwidth() / (8. * pktsize_);
+	int n = int((rtt_ + queue_->limit() / c) / interval_) + 2;
+	if (n > hsize_) {
+		delete [] hwin_;
+		delete [] hprob_;
+		delete [] hrtt_;
+		hwin_ = new double[n];
+		hprob_ = new double[n];
+		hrtt_ = new double[n];
+		hsize_ = n;
+	}
+	for (int i = 0; i < hsize_; i++) {
+		hwin_[i] = win_;
+		hprob_[i] = prob_;
+		hrtt_[i] = rtt_;
+	}
+	hpos_ = 0;
+	link_->txbytes();
+	timer_.resched(interval_);
+}
+
+void FluidModel::stop()
+{
+	timer_.force_cancel();
+	if (queue_ != 0)
+		queue_->background(0);
+	if (link_ != 0)
+		link_->background(0, 0);
+}
+
+/*
+ * Loss probability seen by the aggregate for a total backlog q (pkts)
+ * and a total arrival rate lambda (pkts/s) at capacity c (pkts/s):
+ * either a RED-like linear profile between minth_ and maxth_, or the
+ * overflow fraction of a full tail drop buffer.
+ */
+double FluidModel::loss(double q, double qlim, double lambda, double c)
+{
+	if (maxth_ > 0) {
+		if (q < minth_)
+			return (0);
+		if (q >= maxth_)
+			return (1);
+		return (maxp_ * (q - minth_) / (maxth_ - minth_));
+	}
+	if (q >= qlim - 1 && lambda > c)
+		return (1 - c / lambda);
+	return (0);
+}
+
+void FluidModel::step()
+{
+	double dt = interval_;
+	double bw = link_->bandwidth();
+	double c = bw / (8. * pktsize_);
+	double qlim = queue_->limit();
+	double fgq = queue_->length();
+	double fg = link_->txbytes() / (pktsize_ * dt);
+
+	double rtt = rtt_ + (qlen_ + fgq) / c;
+	int k = int(rtt / dt + 0.5);
+	if (k >= hsize_)
+		k = hsize_ - 1;
+	int j = (hpos_ - k + hsize_) % hsize_;
+
+	win_ += (1 / rtt - win_ * hwin_[j] / (2 * hrtt_[j]) * hprob_[j]) * dt;
+	if (win_ < 1)
+		win_ = 1;
+	if (win_ > maxwin_)
+		win_ = maxwin_;
+	rate_ = nflows_ * win_ / rtt;
+
+	// the fluid is served with whatever the foreground leaves
+	double cb = c - fg;
+	if (cb < 0)
+		cb = 0;
+	double room = qlim - fgq;
+	qlen_ += (rate_ - cb) * dt;
+	if (qlen_ > room)
+		qlen_ = room;
+	if (qlen_ < 0)
+		qlen_ = 0;
+	prob_ = loss(qlen_ + fgq, qlim, rate_ + fg, c);
+
+	hpos_ = (hpos_ + 1) % hsize_;
+	hwin_[hpos_] = win_;
+	hprob_[hpos_] = prob_;
+	hrtt_[hpos_] = rtt;
+
+	// Foreground packets always keep at least the fair share of
+	// one flow, so their transmission time stays finite.
+	double served = (qlen_ > 0 || rate_ > cb) ? cb : rate_;
+	double bgrate = served * 8. * pktsize_;
+	if (bgrate > bw * nflows_ / (nflows_ + 1))
+		bgrate = bw * nflows_ / (nflows_ + 1);
+	link_->background(bgrate, qlen_ / c);
+	queue_->background(int(qlen_ + 0.5));
+
+	timer_.resched(dt);
+}
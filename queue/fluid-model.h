@@ -0,0 +1,77 @@
+/* -*-	Mode:C++; c-basic-offset:8; tab-width:8; indent-tabs-mode:t -*- */
+/*
+ * Fluid model of aggregate background TCP traffic on a link.
+ *
+ * A FluidModel integrates the TCP fluid equations of Misra, Gong and
+ * Towsley (SIGCOMM 2000) for nflows_ long-lived background flows
+ * sharing one link:
+ *
+ *	dW/dt = 1/R(t) - W(t) W(t-R) / (2 R(t-R)) * p(t-R)
+ *	dq/dt = nflows_ W(t) / R(t) - (C - foreground rate)
+ *	R(t)  = rtt_ + (q(t) + foreground backlog) / C
+ *
+ * and couples the result to the packet-level Queue and LinkDelay of
+ * the link: the fluid backlog occupies part of the queue's buffer,
+ * and the rate served to the fluid is taken off the link bandwidth
+ * seen by foreground packets, which also wait behind the fluid
+ * backlog.  The foreground load measured at the LinkDelay is in turn
+ * fed back into the fluid queue, so both directions interact.
+ */
+
+#ifndef ns_fluid_model_h
+#define ns_fluid_model_h
+
+#include "queue.h"
+#include "delay.h"
+#include "timer-handler.h"
+
+class FluidModel;
+
+class FluidTimer : public TimerHandler {
+public:
+	FluidTimer(FluidModel *m) : TimerHandler(), m_(m) {}
+protected:
+	virtual void expire(Event *e);
+	FluidModel *m_;
+};
+
+class FluidModel : public TclObject {
+	friend class FluidTimer;
+public:
+	FluidModel();
+	~FluidModel();
+protected:
+	int command(int argc, const char*const* argv);
+	void start();
+	void stop();
+	void step();			/* one integration step */
+	double loss(double q, double qlim, double lambda, double c);
+
+	Queue* queue_;
+	LinkDelay* link_;
+	FluidTimer timer_;
+
+	int nflows_;			/* number of background flows */
+	double rtt_;			/* round trip propagation delay */
+	int pktsize_;			/* background packet size (bytes) */
+	double interval_;		/* integration step (sec) */
+	double maxwin_;			/* window limit of a flow (pkts) */
+	double minth_;			/* RED-like loss profile, */
+	double maxth_;			/*  tail drop if maxth_ is 0 */
+	double maxp_;
+
+	double win_;			/* window of a flow (pkts) */
+	double qlen_;			/* fluid backlog (pkts) */
+	double rate_;			/* aggregate sending rate (pkts/s) */
+	double prob_;			/* loss probability */
+
+	/* history of W, p and R, one slot per step, for the
+	 * delayed terms of the window equation */
+	double* hwin_;
+	double* hprob_;
+	double* hrtt_;
+	int hsize_;
+	int hpos_;
+};
+
+#endif
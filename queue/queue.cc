@@ -88,7 +88,7 @@ void QueueHandler::handle(Event*)
 Queue::~Queue() {
 }
 
-Queue::Queue() : Connector(), blocked_(0), unblock_on_resume_(1), qh_(*this),
+Queue::Queue() : Connector(), bglen_(0), blocked_(0), unblock_on_resume_(1), qh_(*this),
 		 pq_(0), 
 		 last_change_(0), /* temporarily NULL */
 		 old_util_(0), period_begin_(0), cur_util_(0), buf_slot_(0),
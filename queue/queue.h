@@ -92,6 +92,20 @@ public:
 		++len_;
 		bytes_ += hdr_cmn::access(p)->size();
 	}
+	/* insert p after a given packet, which must be in the queue;
+	 * at the head if prev is 0 */
+	void enqueAfter(Packet* prev, Packet* p) {
+		if (prev == 0) {
+			enqueHead(p);
+			return;
+		}
+		p->next_ = prev->next_;
+		prev->next_ = p;
+		if (prev == tail_)
+			tail_ = p;
+		++len_;
+		bytes_ += hdr_cmn::access(p)->size();
+	}
         void resetIterator() {iter = head_;}
         Packet* getNext() { 
 	        if (!iter) return 0;
@@ -134,6 +148,8 @@ public:
 	void unblock() { blocked_ = 0; }
 	void block() { blocked_ = 1; }
 	int limit() { return qlim_; }
+	/* set the fluid background occupancy sharing the buffer */
+	void background(int len) { bglen_ = len; }
 	int length() { return pq_->length(); }	/* number of pkts currently in
 						 * underlying packet queue */
 	int byteLength() { return pq_->byteLength(); }	/* number of bytes *
@@ -149,6 +165,8 @@ protected:
 	Queue();
 	void reset();
 	int qlim_;		/* maximum allowed pkts in queue */
+	int bglen_;		/* pkts of background fluid traffic held
+				 * in the buffer (see FluidModel) */
 	int blocked_;		/* blocked now? */
 	int unblock_on_resume_;	/* unblock q on idle? */
 	QueueHandler qh_;
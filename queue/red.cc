@@ -646,7 +646,10 @@ void REDQueue::enque(Packet* pkt)
 	 * Run the estimator with either 1 new packet arrival, or with
 	 * the scaled version above [scaled by m due to idle time]
 	 */
-	edv_.v_ave = estimator(qib_ ? q_->byteLength() : q_->length(), m + 1, edv_.v_ave, edp_.q_w);
+	// bglen_ is the fluid background backlog sharing the buffer
+	int bglen = qib_ ? bglen_ * edp_.mean_pktsize : bglen_;
+	edv_.v_ave = estimator((qib_ ? q_->byteLength() : q_->length()) + bglen,
+	    m + 1, edv_.v_ave, edp_.q_w);
 	//printf("v_ave: %6.4f (%13.12f) q: %d)\n", 
 	//	double(edv_.v_ave), double(edv_.v_ave), q_->length());
 	if (summarystats_) {
@@ -674,7 +677,7 @@ void REDQueue::enque(Packet* pkt)
 
 	register double qavg = edv_.v_ave;
 	int droptype = DTYPE_NONE;
-	int qlen = qib_ ? q_->byteLength() : q_->length();
+	int qlen = (qib_ ? q_->byteLength() : q_->length()) + bglen;
 	int qlim = qib_ ? (qlim_ * edp_.mean_pktsize) : qlim_;
 
 	curq_ = qlen;	// helps to trace queue during arrival, if enabled
@@ -63,6 +63,19 @@ void RouteLogic::reset_all()
 	adj_ = 0; 
 	route_ = 0;
 	size_ = 0;
+
+	delete[] edges_;
+	delete[] csr_off_;
+	delete[] csr_dst_;
+	delete[] csr_cost_;
+	delete[] nhop_;
+	edges_ = 0;
+	nedges_ = maxedges_ = 0;
+	csr_off_ = csr_dst_ = 0;
+	csr_cost_ = 0;
+	nhop_ = 0;
+	nsize_ = 0;
+	lru_reset();
 }
 
 int RouteLogic::command(int argc, const char*const* argv)
@@ -70,6 +83,21 @@ int RouteLogic::command(int argc, const char*const* argv)
 	Tcl& tcl = Tcl::instance();
 	if (argc == 2) {
 		if (strcmp(argv[1], "compute") == 0) {
+			delete[] nhop_;
+			nhop_ = 0;
+			lru_reset();
+			if (lazy_) {
+				if (edges_ != 0) {
+					sparse_build();
+					lru_alloc();
+				}
+				return (TCL_OK);
+			}
+			if (sparse_) {
+				if (edges_ != 0)
+					compute_sparse();
+				return (TCL_OK);
+			}
 			if (adj_ == 0)
 				return (TCL_OK);
 			compute_routes();
@@ -89,6 +117,14 @@ int RouteLogic::command(int argc, const char*const* argv)
 		} else if (strcmp(argv[1], "reset") == 0) {
 			reset_all();
 			return (TCL_OK);
+		} else if (strcmp(argv[1], "check-routes") == 0) {
+			/* number of pairs on which compute_routes() differs */
+			if (edges_ == 0 || !computed()) {
+				tcl.result("no sparse or lazy routes computed");
+				return (TCL_ERROR);
+			}
+			tcl.resultf("%d", check_routes());
+			return (TCL_OK);
 		}
 	} else if (argc > 2) {
 		if (strcmp(argv[1], "insert") == 0) {
@@ -207,7 +243,7 @@ int RouteLogic::lookup_flat(char* asrc, char* adst, int& result) {
 	int src = atoi(asrc) + 1;
 	int dst = atoi(adst) + 1;
 
-	if (route_ == 0) {
+	if (!computed()) {
 		// routes are computed only after the simulator is running
 		// ($ns run).
 		tcl.result("routes not yet computed");
@@ -217,7 +253,7 @@ int RouteLogic::lookup_flat(char* asrc, char* adst, int& result) {
 		tcl.result("node out of range");
 		return (TCL_ERROR);
 	}
-	result = route_[INDEX(src, dst, size_)].next_hop - 1;
+	result = next_hop(src, dst) - 1;
 	return TCL_OK;
 }
 
@@ -226,7 +262,7 @@ int RouteLogic::lookup_flat(char* asrc, char* adst, int& result) {
 int RouteLogic::lookup_flat(int sid, int did) {
 	int src = sid+1;
 	int dst = did+1;
-	if (route_ == 0) {
+	if (!computed()) {
 		// routes are computed only after the simulator is running
 		// ($ns run).
 		printf("routes not yet computed\n");
@@ -236,7 +272,7 @@ int RouteLogic::lookup_flat(int sid, int did) {
 		printf("node out of range\n");
 		return (-2);
 	}
-	return route_[INDEX(src, dst, size_)].next_hop - 1;
+	return next_hop(src, dst) - 1;
 }
 
 // xxx: using references as in this result is bogus---use pointers!
@@ -322,12 +358,40 @@ RouteLogic::RouteLogic()
 	hroute_ = 0;
 	hconnect_ = 0;
 	cluster_size_ = 0;
+	/* sparse route computation */
+	edges_ = 0;
+	nedges_ = maxedges_ = 0;
+	csr_off_ = csr_dst_ = 0;
+	csr_cost_ = 0;
+	unit_ = 0;
+	nhop_ = 0;
+	nhopw_ = 0;
+	nsize_ = 0;
+	pthread_mutex_init(&spf_lock_, 0);
+	lru_row_ = lru_src_ = lru_slot_ = lru_prev_ = lru_next_ = 0;
+	lru_head_ = lru_tail_ = -1;
+	lru_size_ = lru_used_ = 0;
+	spf_dist_ = 0;
+	spf_heap_ = 0;
+	spf_done_ = 0;
+	spf_level_ = spf_queue_ = spf_parent_ = 0;
+	bind_bool("sparse_", &sparse_);
+	bind("threads_", &threads_);
+	bind_bool("lazy_", &lazy_);
+	bind("cache_", &cache_);
 }
 	
 RouteLogic::~RouteLogic()
 {
 	delete[] adj_;
 	delete[] route_;
+	delete[] edges_;
+	delete[] csr_off_;
+	delete[] csr_dst_;
+	delete[] csr_cost_;
+	delete[] nhop_;
+	pthread_mutex_destroy(&spf_lock_);
+	lru_reset();
 
 	for (int i = 0; i < (Cmax_ * D_); i++) {
 		for (int j = 0; j < (Cmax_ + D_) * (cluster_size_[i]+1); j++) {
@@ -391,12 +455,20 @@ void RouteLogic::check(int n)
 
 void RouteLogic::insert(int src, int dst, double cost)
 {
+	if (sparse_ || lazy_) {
+		sparse_insert(src, dst, cost);
+		return;
+	}
 	check(src);
 	check(dst);
 	adj_[INDEX(src, dst, size_)].cost = cost;
 }
 void RouteLogic::insert(int src, int dst, double cost, void* entry_)
 {
+	if (sparse_ || lazy_) {
+		sparse_insert(src, dst, cost);
+		return;
+	}
 	check(src);
 	check(dst);
 	adj_[INDEX(src, dst, size_)].cost = cost;
@@ -405,71 +477,128 @@ void RouteLogic::insert(int src, int dst, double cost, void* entry_)
 
 void RouteLogic::reset(int src, int dst)
 {
+	if (sparse_ || lazy_) {
+		sparse_insert(src, dst, INFINITY);
+		return;
+	}
 	assert(src < size_);
 	assert(dst < size_);
 	adj_[INDEX(src, dst, size_)].cost = INFINITY;
 }
 
-void RouteLogic::compute_routes()
+/*
+ * Routes from source k, into row k of route_.  The rows are independent,
+ * so compute_routes() spreads the sources over threads_ threads as
+ * compute_sparse() does.
+ */
+void RouteLogic::dense_source(int k, int* parent, double* hopcnt)
 {
 	int n = size_;
-	int* parent = new int[n];
-	double* hopcnt = new double[n];
 #define ADJ(i, j) adj_[INDEX(i, j, size_)].cost
 #define ADJ_ENTRY(i, j) adj_[INDEX(i, j, size_)].entry
 #define ROUTE(i, j) route_[INDEX(i, j, size_)].next_hop
 #define ROUTE_ENTRY(i, j) route_[INDEX(i, j, size_)].entry
+	int v;
+	for (v = 0; v < n; v++)
+		parent[v] = v;
+
+	/* set the route for all neighbours first */
+	for (v = 1; v < n; ++v) {
+		if (parent[v] != k) {
+			hopcnt[v] = ADJ(k, v);
+			if (hopcnt[v] != INFINITY) {
+				ROUTE(k, v) = v;
+				ROUTE_ENTRY(k, v) = ADJ_ENTRY(k, v);
+			}
+		}
+	}
+	for (v = 1; v < n; ++v) {
+		/*
+		 * w is the node that is the nearest to the subtree
+		 * that has been routed
+		 */
+		int o = 0;
+		/* XXX */
+		hopcnt[0] = INFINITY;
+		int w;
+		for (w = 1; w < n; w++)
+			if (parent[w] != k && hopcnt[w] < hopcnt[o])
+				o = w;
+		parent[o] = k;
+		/*
+		 * update distance counts for the nodes that are
+		 * adjacent to o
+		 */
+		if (o == 0)
+			continue;
+		for (w = 1; w < n; w++) {
+			if (parent[w] != k &&
+			    hopcnt[o] + ADJ(o, w) < hopcnt[w]) {
+				ROUTE(k, w) = ROUTE(k, o);
+				ROUTE_ENTRY(k, w) = 
+				    ROUTE_ENTRY(k, o);
+				hopcnt[w] = hopcnt[o] + ADJ(o, w);
+			}
+		}
+	}
+}
+
+/* number of sources a thread takes at a time */
+#define DENSE_CHUNK	16
+
+void RouteLogic::dense_worker()
+{
+	int n = size_;
+	int* parent = new int[n];
+	double* hopcnt = new double[n];
+	for (;;) {
+		pthread_mutex_lock(&spf_lock_);
+		int k = spf_next_;
+		spf_next_ += DENSE_CHUNK;
+		pthread_mutex_unlock(&spf_lock_);
+		if (k >= n)
+			break;
+		int e = k + DENSE_CHUNK < n ? k + DENSE_CHUNK : n;
+		for (; k < e; k++)
+			dense_source(k, parent, hopcnt);
+	}
+	delete[] hopcnt;
+	delete[] parent;
+}
+
+void* RouteLogic::dense_thread(void* arg)
+{
+	((RouteLogic*)arg)->dense_worker();
+	return (0);
+}
+
+void RouteLogic::compute_routes()
+{
+	int n = size_;
 	delete[] route_;
 	route_ = new route_entry[n * n];
 	memset((char *)route_, 0, n * n * sizeof(route_[0]));
 
 	/* do for all the sources */
-	int k;
-	for (k = 1; k < n; ++k) {
-		int v;
-		for (v = 0; v < n; v++)
-			parent[v] = v;
-	
-		/* set the route for all neighbours first */
-		for (v = 1; v < n; ++v) {
-			if (parent[v] != k) {
-				hopcnt[v] = ADJ(k, v);
-				if (hopcnt[v] != INFINITY) {
-					ROUTE(k, v) = v;
-					ROUTE_ENTRY(k, v) = ADJ_ENTRY(k, v);
-				}
-			}
-		}
-		for (v = 1; v < n; ++v) {
-			/*
-			 * w is the node that is the nearest to the subtree
-			 * that has been routed
-			 */
-			int o = 0;
-			/* XXX */
-			hopcnt[0] = INFINITY;
-			int w;
-			for (w = 1; w < n; w++)
-				if (parent[w] != k && hopcnt[w] < hopcnt[o])
-					o = w;
-			parent[o] = k;
-			/*
-			 * update distance counts for the nodes that are
-			 * adjacent to o
-			 */
-			if (o == 0)
-				continue;
-			for (w = 1; w < n; w++) {
-				if (parent[w] != k &&
-				    hopcnt[o] + ADJ(o, w) < hopcnt[w]) {
-					ROUTE(k, w) = ROUTE(k, o);
-					ROUTE_ENTRY(k, w) = 
-					    ROUTE_ENTRY(k, o);
-					hopcnt[w] = hopcnt[o] + ADJ(o, w);
-				}
-			}
+	spf_next_ = 1;
+	int nthreads = threads_;
+	if (nthreads > (n + DENSE_CHUNK - 1) / DENSE_CHUNK)
+		nthreads = (n + DENSE_CHUNK - 1) / DENSE_CHUNK;
+	pthread_t* tid = 0;
+	int k, started = 0;
+	if (nthreads > 1) {
+		tid = new pthread_t[nthreads - 1];
+		for (k = 0; k < nthreads - 1; k++) {
+			if (pthread_create(&tid[k], 0, dense_thread, this) != 0)
+				break;
+			started++;
 		}
 	}
+	dense_worker();
+	for (k = 0; k < started; k++)
+		pthread_join(tid[k], 0);
+	delete[] tid;
+
 	/*
 	 * The route to yourself is yourself.
 	 */
@@ -477,11 +606,478 @@ void RouteLogic::compute_routes()
 		ROUTE(k, k) = k;
 		ROUTE_ENTRY(k, k) = 0; // This should not matter
 	}
+}
 
-	delete[] hopcnt;
+#undef DENSE_CHUNK
+
+/*
+ * Sparse route computation.
+ *
+ * With sparse_ set, insert() and reset() only record the links, and
+ * compute_sparse() packs them into a compressed sparse row (CSR)
+ * adjacency list and runs one single source shortest path computation
+ * per node: a binary heap Dijkstra, or a breadth first search when all
+ * the link costs are 1.  This is O(n m log n) time instead of the
+ * O(n^3) of compute_routes(), the graph takes O(n + m) space instead
+ * of the n^2 adj_entry matrix, and the sources are spread over
+ * threads_ threads.  The result is still an n x n table (nhop_), but
+ * it stores a next hop as its position among the links of the source,
+ * in one byte per pair as long as no node has 255 links or more: about
+ * 100MB for 10000 nodes, against 1.6GB of route_entry.
+ *
+ * Ties are broken exactly as in compute_routes(): among the nodes at
+ * the same distance the one with the lowest number is settled first,
+ * and a route is only replaced by a strictly shorter one, so both
+ * modes compute the same routes.
+ */
+void RouteLogic::sparse_insert(int src, int dst, double cost)
+{
+	if (nedges_ == maxedges_) {
+		maxedges_ = maxedges_ ? 2 * maxedges_ : 256;
+		sparse_edge* e = new sparse_edge[maxedges_];
+		if (nedges_ > 0)
+			memcpy(e, edges_, nedges_ * sizeof(sparse_edge));
+		delete[] edges_;
+		edges_ = e;
+	}
+	sparse_edge& e = edges_[nedges_];
+	e.src = src;
+	e.dst = dst;
+	e.seq = nedges_++;
+	e.cost = cost;
+	/* keep size_ as check() would grow it, for lookup_flat() */
+	int n = src > dst ? src : dst;
+	if (size_ == 0)
+		size_ = 16;
+	while (size_ <= n)
+		size_ <<= 1;
+}
+
+static int sparse_edge_cmp(const void* a, const void* b)
+{
+	const sparse_edge* x = (const sparse_edge*)a;
+	const sparse_edge* y = (const sparse_edge*)b;
+	if (x->src != y->src)
+		return (x->src - y->src);
+	if (x->dst != y->dst)
+		return (x->dst - y->dst);
+	return (x->seq - y->seq);
+}
+
+/*
+ * Sort the links, keep the last insert() or reset() of each (src, dst)
+ * pair and build the CSR arrays.  The edge list is compacted in place
+ * so that repeated computations do not let it grow.
+ */
+void RouteLogic::sparse_build()
+{
+	qsort(edges_, nedges_, sizeof(sparse_edge), sparse_edge_cmp);
+	int i, m = 0;
+	nsize_ = 0;
+	for (i = 0; i < nedges_; i++) {
+		if (i + 1 < nedges_ && edges_[i + 1].src == edges_[i].src &&
+		    edges_[i + 1].dst == edges_[i].dst)
+			continue;
+		if (edges_[i].cost >= INFINITY ||
+		    edges_[i].src == edges_[i].dst)
+			continue;
+		edges_[m] = edges_[i];
+		edges_[m].seq = m;
+		if (edges_[m].src >= nsize_)
+			nsize_ = edges_[m].src + 1;
+		if (edges_[m].dst >= nsize_)
+			nsize_ = edges_[m].dst + 1;
+		m++;
+	}
+	nedges_ = m;
+
+	delete[] csr_off_;
+	delete[] csr_dst_;
+	delete[] csr_cost_;
+	csr_off_ = new int[nsize_ + 1];
+	csr_dst_ = new int[m > 0 ? m : 1];
+	csr_cost_ = new double[m > 0 ? m : 1];
+	memset(csr_off_, 0, (nsize_ + 1) * sizeof(int));
+	unit_ = 1;
+	for (i = 0; i < m; i++) {
+		csr_off_[edges_[i].src + 1]++;
+		csr_dst_[i] = edges_[i].dst;
+		csr_cost_[i] = edges_[i].cost;
+		if (edges_[i].cost != 1)
+			unit_ = 0;
+	}
+	for (i = 0; i < nsize_; i++)
+		csr_off_[i + 1] += csr_off_[i];
+}
+
+/* heap entries are ordered by (dist, node number) */
+#define SPF_LESS(a, b) ((a).dist < (b).dist || \
+			((a).dist == (b).dist && (a).node < (b).node))
+
+void RouteLogic::spf_source(int src, int* row, double* dist, spf_heap* heap,
+			    char* done)
+{
+	int n = nsize_;
+	int v;
+	for (v = 0; v < n; v++) {
+		dist[v] = INFINITY;
+		done[v] = 0;
+		row[v] = 0;
+	}
+	row[src] = src;
+	dist[src] = 0;
+
+	/*
+	 * A node is pushed again each time its distance decreases and
+	 * the stale entries are skipped, so the heap holds at most
+	 * one entry per link (plus the source).
+	 */
+	int nheap = 0;
+	heap[nheap].dist = 0;
+	heap[nheap++].node = src;
+	while (nheap > 0) {
+		int o = heap[0].node;
+		spf_heap last = heap[--nheap];
+		int i = 0;
+		for (;;) {
+			int c = 2 * i + 1;
+			if (c >= nheap)
+				break;
+			if (c + 1 < nheap && SPF_LESS(heap[c + 1], heap[c]))
+				c++;
+			if (!SPF_LESS(heap[c], last))
+				break;
+			heap[i] = heap[c];
+			i = c;
+		}
+		heap[i] = last;
+		if (done[o])
+			continue;
+		done[o] = 1;
+
+		for (int e = csr_off_[o]; e < csr_off_[o + 1]; e++) {
+			spf_heap h;
+			h.node = csr_dst_[e];
+			h.dist = dist[o] + csr_cost_[e];
+			if (done[h.node] || !(h.dist < dist[h.node]))
+				continue;
+			dist[h.node] = h.dist;
+			row[h.node] = (o == src) ? h.node : row[o];
+			/* sift up */
+			i = nheap++;
+			while (i > 0 && SPF_LESS(h, heap[(i - 1) / 2])) {
+				heap[i] = heap[(i - 1) / 2];
+				i = (i - 1) / 2;
+			}
+			heap[i] = h;
+		}
+	}
+}
+
+#undef SPF_LESS
+
+/*
+ * With unit costs Dijkstra settles the nodes level by level, in node
+ * number order within a level, so a node's route is that of its lowest
+ * numbered neighbour on the previous level.
+ */
+void RouteLogic::bfs_source(int src, int* row, int* level, int* queue,
+			    int* parent)
+{
+	int n = nsize_;
+	int v;
+	for (v = 0; v < n; v++) {
+		level[v] = -1;
+		row[v] = 0;
+	}
+	row[src] = src;
+	level[src] = 0;
+	int head = 0, tail = 0;
+	queue[tail++] = src;
+	while (head < tail) {
+		int o = queue[head++];
+		if (level[o] + 1 >= INFINITY)
+			break;
+		for (int e = csr_off_[o]; e < csr_off_[o + 1]; e++) {
+			int w = csr_dst_[e];
+			if (level[w] < 0) {
+				level[w] = level[o] + 1;
+				parent[w] = o;
+				row[w] = (o == src) ? w : row[o];
+				queue[tail++] = w;
+			} else if (level[w] == level[o] + 1 && o < parent[w]) {
+				parent[w] = o;
+				row[w] = row[o];
+			}
+		}
+	}
+}
+
+/* number of sources a thread takes at a time */
+#define SPF_CHUNK	16
+
+void RouteLogic::spf_worker()
+{
+	int n = nsize_;
+	double* dist = 0;
+	spf_heap* heap = 0;
+	char* done = 0;
+	int* level = 0;
+	int* queue = 0;
+	int* parent = 0;
+	int* row = new int[n];
+	int* pos = new int[n];
+	memset(pos, 0, n * sizeof(int));
+	if (unit_) {
+		level = new int[n];
+		queue = new int[n];
+		parent = new int[n];
+	} else {
+		dist = new double[n];
+		heap = new spf_heap[nedges_ + 1];
+		done = new char[n];
+	}
+	for (;;) {
+		pthread_mutex_lock(&spf_lock_);
+		int s = spf_next_;
+		spf_next_ += SPF_CHUNK;
+		pthread_mutex_unlock(&spf_lock_);
+		if (s >= n)
+			break;
+		int e = s + SPF_CHUNK < n ? s + SPF_CHUNK : n;
+		for (; s < e; s++) {
+			if (unit_)
+				bfs_source(s, row, level, queue, parent);
+			else
+				spf_source(s, row, dist, heap, done);
+			nhop_pack(s, row, pos);
+		}
+	}
+	delete[] row;
+	delete[] pos;
+	delete[] dist;
+	delete[] heap;
+	delete[] done;
+	delete[] level;
+	delete[] queue;
 	delete[] parent;
 }
 
+/*
+ * Store the next hops of src, as node numbers in row, into nhop_.  pos
+ * is all zeroes on entry and on return.
+ */
+void RouteLogic::nhop_pack(int src, const int* row, int* pos)
+{
+	int n = nsize_;
+	int off = csr_off_[src];
+	int e, d;
+	for (e = off; e < csr_off_[src + 1]; e++)
+		pos[csr_dst_[e]] = e - off + 1;
+	size_t base = (size_t)src * n;
+	for (d = 0; d < n; d++) {
+		unsigned int k = (d == src || row[d] == 0) ? 0 : pos[row[d]];
+		if (nhopw_ == 1)
+			nhop_[base + d] = k;
+		else if (nhopw_ == 2)
+			((unsigned short*)nhop_)[base + d] = k;
+		else
+			((unsigned int*)nhop_)[base + d] = k;
+	}
+	for (e = off; e < csr_off_[src + 1]; e++)
+		pos[csr_dst_[e]] = 0;
+}
+
+void* RouteLogic::spf_thread(void* arg)
+{
+	((RouteLogic*)arg)->spf_worker();
+	return (0);
+}
+
+void RouteLogic::compute_sparse()
+{
+	sparse_build();
+	int n = nsize_;
+	delete[] route_;
+	route_ = 0;
+	int i, deg = 0;
+	for (i = 0; i < n; i++)
+		if (csr_off_[i + 1] - csr_off_[i] > deg)
+			deg = csr_off_[i + 1] - csr_off_[i];
+	nhopw_ = deg < 0x100 ? 1 : (deg < 0x10000 ? 2 : 4);
+	nhop_ = new unsigned char[(size_t)n * n * nhopw_];
+	memset(nhop_, 0, (size_t)n * n * nhopw_);
+
+	/* node 0 is unused (node numbers are offset by one) */
+	spf_next_ = 1;
+	int nthreads = threads_;
+	if (nthreads > (n + SPF_CHUNK - 1) / SPF_CHUNK)
+		nthreads = (n + SPF_CHUNK - 1) / SPF_CHUNK;
+	pthread_t* tid = 0;
+	int started = 0;
+	if (nthreads > 1) {
+		tid = new pthread_t[nthreads - 1];
+		for (i = 0; i < nthreads - 1; i++) {
+			if (pthread_create(&tid[i], 0, spf_thread, this) != 0)
+				break;
+			started++;
+		}
+	}
+	/* this thread does its share, or all of it */
+	spf_worker();
+	for (i = 0; i < started; i++)
+		pthread_join(tid[i], 0);
+	delete[] tid;
+}
+
+#undef SPF_CHUNK
+
+/*
+ * Rebuild the dense adjacency matrix from the sparse graph, run
+ * compute_routes() on it and count the (src, dst) pairs whose next hop
+ * differs from the sparse or lazy one.  For the validation tests.
+ */
+int RouteLogic::check_routes()
+{
+	adj_entry* oadj = adj_;
+	route_entry* oroute = route_;
+	int osize = size_;
+	int i, d, bad = 0;
+
+	alloc(size_);
+	for (i = 0; i < nedges_; i++)
+		adj_[INDEX(edges_[i].src, edges_[i].dst, size_)].cost =
+			edges_[i].cost;
+	route_ = 0;
+	compute_routes();
+	route_entry* dense = route_;
+	route_ = oroute;
+	for (i = 1; i < nsize_; i++) {
+		for (d = 1; d < nsize_; d++) {
+			if (d != i && dense[INDEX(i, d, size_)].next_hop !=
+			    next_hop(i, d))
+				bad++;
+		}
+	}
+	delete[] dense;
+	delete[] adj_;
+	adj_ = oadj;
+	size_ = osize;
+	return (bad);
+}
+
+/*
+ * Lazy route computation.
+ *
+ * With lazy_ set, compute only builds the CSR graph, and the routes of
+ * a source are computed by the first lookup from it.  This is meant
+ * for static routing with LazyRoute objects (see simulator.cc) as the
+ * default targets of the node classifiers, so that a node only asks
+ * for the routes it actually uses, and the memory is bounded by the
+ * cache_ rows of the LRU list.
+ */
+void RouteLogic::lru_alloc()
+{
+	int n = nsize_ > 0 ? nsize_ : 1;
+	int c = cache_ > 0 ? cache_ : 1;
+	if (c > n)
+		c = n;
+	lru_row_ = new int[(size_t)c * n];
+	lru_src_ = new int[c];
+	lru_prev_ = new int[c];
+	lru_next_ = new int[c];
+	lru_slot_ = new int[n];
+	for (int i = 0; i < n; i++)
+		lru_slot_[i] = -1;
+	lru_size_ = c;
+	lru_head_ = lru_tail_ = -1;
+	lru_used_ = 0;
+	if (unit_) {
+		spf_dist_ = 0;
+		spf_heap_ = 0;
+		spf_done_ = 0;
+		spf_level_ = new int[n];
+		spf_queue_ = new int[n];
+		spf_parent_ = new int[n];
+	} else {
+		spf_dist_ = new double[n];
+		spf_heap_ = new spf_heap[nedges_ + 1];
+		spf_done_ = new char[n];
+		spf_level_ = spf_queue_ = spf_parent_ = 0;
+	}
+}
+
+void RouteLogic::lru_reset()
+{
+	delete[] lru_row_;
+	delete[] lru_src_;
+	delete[] lru_slot_;
+	delete[] lru_prev_;
+	delete[] lru_next_;
+	delete[] spf_dist_;
+	delete[] spf_heap_;
+	delete[] spf_done_;
+	delete[] spf_level_;
+	delete[] spf_queue_;
+	delete[] spf_parent_;
+	lru_row_ = lru_src_ = lru_slot_ = lru_prev_ = lru_next_ = 0;
+	spf_dist_ = 0;
+	spf_heap_ = 0;
+	spf_done_ = 0;
+	spf_level_ = spf_queue_ = spf_parent_ = 0;
+	lru_size_ = lru_used_ = 0;
+	lru_head_ = lru_tail_ = -1;
+}
+
+int* RouteLogic::source_row(int src)
+{
+	int s = lru_slot_[src];
+	if (s >= 0) {
+		if (s != lru_head_) {
+			/* move to the front */
+			lru_next_[lru_prev_[s]] = lru_next_[s];
+			if (s == lru_tail_)
+				lru_tail_ = lru_prev_[s];
+			else
+				lru_prev_[lru_next_[s]] = lru_prev_[s];
+			lru_prev_[s] = -1;
+			lru_next_[s] = lru_head_;
+			lru_prev_[lru_head_] = s;
+			lru_head_ = s;
+		}
+		return (lru_row_ + INDEX(s, 0, nsize_));
+	}
+
+	if (lru_used_ < lru_size_)
+		s = lru_used_++;
+	else {
+		/* evict the least recently used row */
+		s = lru_tail_;
+		lru_slot_[lru_src_[s]] = -1;
+		lru_tail_ = lru_prev_[s];
+		if (lru_tail_ >= 0)
+			lru_next_[lru_tail_] = -1;
+		else
+			lru_head_ = -1;
+	}
+	lru_src_[s] = src;
+	lru_slot_[src] = s;
+	lru_prev_[s] = -1;
+	lru_next_[s] = lru_head_;
+	if (lru_head_ >= 0)
+		lru_prev_[lru_head_] = s;
+	else
+		lru_tail_ = s;
+	lru_head_ = s;
+
+	int* row = lru_row_ + INDEX(s, 0, nsize_);
+	if (unit_)
+		bfs_source(src, row, spf_level_, spf_queue_, spf_parent_);
+	else
+		spf_source(src, row, spf_dist_, spf_heap_, spf_done_);
+	return (row);
+}
+
 /* hierarchical routing support */
 
 /*
@@ -43,6 +43,8 @@
 #ifndef ns_route_h
 #define ns_route_h
 
+#include <pthread.h>
+
 #undef INFINITY
 #define INFINITY	0x3fff
 #define INDEX(i, j, N) ((N) * (i) + (j))
@@ -70,6 +72,19 @@ public:
 	void* entry;
 };
 
+/* a link of the sparse topology, see RouteLogic::compute_sparse() */
+struct sparse_edge {
+	int src;
+	int dst;
+	int seq;		/* insertion order, the last one wins */
+	double cost;
+};
+
+struct spf_heap {
+	double dist;
+	int node;
+};
+
 class RouteLogic : public TclObject {
 public:
 	RouteLogic();
@@ -89,6 +104,9 @@ protected:
 	void alloc(int n);
 	void reset(int src, int dst);
 	void compute_routes();
+	void dense_source(int k, int* parent, double* hopcnt);
+	void dense_worker();
+	static void* dense_thread(void* arg);
 	void insert(int src, int dst, double cost);
 	adj_entry *adj_;
 	route_entry *route_;
@@ -97,6 +115,91 @@ protected:
 	int size_,
 		maxnode_;
 
+	/**** Sparse (CSR) route computation ****/
+
+	void sparse_insert(int src, int dst, double cost);
+	void sparse_build();
+	void compute_sparse();
+	void spf_source(int src, int* row, double* dist, spf_heap* heap,
+			char* done);
+	void bfs_source(int src, int* row, int* level, int* queue,
+			int* parent);
+	int* source_row(int src);
+	void lru_alloc();
+	void lru_reset();
+	void spf_worker();
+	static void* spf_thread(void* arg);
+	inline int computed() {
+		return (route_ != 0 || nhop_ != 0 || lru_row_ != 0);
+	}
+	inline int next_hop(int src, int dst) {
+		if (nhop_ == 0 && lru_row_ == 0)
+			return (route_[INDEX(src, dst, size_)].next_hop);
+		if (src == dst)
+			return (src);
+		if (src >= nsize_ || dst >= nsize_)
+			return (0);
+		if (nhop_ != 0)
+			return (nhop_get(src, dst));
+		return (source_row(src)[dst]);
+	}
+	inline int nhop_get(int src, int dst) {
+		size_t i = (size_t)src * nsize_ + dst;
+		unsigned int k;
+		if (nhopw_ == 1)
+			k = nhop_[i];
+		else if (nhopw_ == 2)
+			k = ((unsigned short*)nhop_)[i];
+		else
+			k = ((unsigned int*)nhop_)[i];
+		return (k == 0 ? 0 : csr_dst_[csr_off_[src] + k - 1]);
+	}
+	void nhop_pack(int src, const int* row, int* pos);
+	int check_routes();
+
+	int sparse_;		/* use the CSR graph instead of adj_ */
+	int threads_;		/* worker threads for the route computation */
+	sparse_edge* edges_;	/* links as inserted */
+	int nedges_;
+	int maxedges_;
+	int* csr_off_;		/* links of node i are csr_off_[i] .. */
+	int* csr_dst_;		/*   csr_off_[i+1]-1 in csr_dst_/csr_cost_ */
+	double* csr_cost_;
+	int unit_;		/* all costs are 1, use BFS */
+	/*
+	 * Next hop table, nsize_ x nsize_ entries of nhopw_ bytes: 1 +
+	 * the position of the next hop among the links of the source
+	 * in csr_dst_, or 0 if the destination is unreachable.
+	 */
+	unsigned char* nhop_;
+	int nhopw_;
+	int nsize_;		/* 1 + highest node in the sparse graph */
+	pthread_mutex_t spf_lock_;	/* protects spf_next_ */
+	int spf_next_;		/* next source to compute */
+
+	/*
+	 * Lazy mode: the next hops of a source are only computed when
+	 * it is first looked up, and the rows of the cache_ most
+	 * recently used sources are kept in an LRU list.
+	 */
+	int lazy_;
+	int cache_;		/* max number of rows kept */
+	int* lru_row_;		/* cache_ rows of nsize_ next hops */
+	int* lru_src_;		/* source of each row, */
+	int* lru_slot_;		/*  and row of each source or -1 */
+	int* lru_prev_;		/* LRU list of rows, */
+	int* lru_next_;		/*  most recently used first */
+	int lru_head_;
+	int lru_tail_;
+	int lru_size_;		/* rows allocated */
+	int lru_used_;		/* rows in use */
+	double* spf_dist_;	/* workspace of source_row() */
+	spf_heap* spf_heap_;
+	char* spf_done_;
+	int* spf_level_;
+	int* spf_queue_;
+	int* spf_parent_;
+
 	/**** Hierarchical routing support ****/
 
 	void hier_check(int index);
@@ -117,13 +117,27 @@ double SatGeometry::get_longitude(coordinate coord_)
 double SatGeometry::check_elevation(coordinate satellite,
     coordinate terminal, double elev_mask_)
 {
-	double S = satellite.r;  // satellite radius
-	double S_2 = satellite.r * satellite.r;  // satellite radius^2
+        double s_x, s_y, s_z, t_x, t_y, t_z;     // cartesian
+	spherical_to_cartesian(satellite.r, satellite.theta, satellite.phi,
+	    s_x, s_y, s_z);
+	spherical_to_cartesian(terminal.r, terminal.theta, terminal.phi,
+	    t_x, t_y, t_z);
+	return (check_elevation(s_x, s_y, s_z, satellite.r, t_x, t_y, t_z,
+	    elev_mask_));
+}
+
+// Same as above, for a satellite at cartesian (s_x, s_y, s_z) with radius
+// S and a terminal at (t_x, t_y, t_z).  Callers that check many pairs at
+// the same time convert each position only once.
+double SatGeometry::check_elevation(double s_x, double s_y, double s_z,
+    double S, double t_x, double t_y, double t_z, double elev_mask_)
+{
+	double S_2 = S * S;  // satellite radius^2
 	double E = EARTH_RADIUS;
 	double E_2 = E * E;
 	double d, theta, alpha;
 
-	d = distance(satellite, terminal);
+	d = BaseTrace::round(DISTANCE(s_x, s_y, s_z, t_x, t_y, t_z), 1.0E+8);
 	if (d < sqrt(S_2 - E_2)) {
 		// elevation angle > 0
 		theta = acos((E_2+S_2-(d*d))/(2*E*S));
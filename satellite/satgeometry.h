@@ -80,6 +80,8 @@ public:
 	static double get_radius(coordinate a) { return a.r; }
 	static double get_altitude(coordinate);
 	static double check_elevation(coordinate, coordinate, double);
+	static double check_elevation(double, double, double, double,
+	    double, double, double, double);
 	static int are_satellites_mutually_visible(coordinate, coordinate);
 
 protected: 
@@ -184,19 +184,167 @@ SatNode* LinkHandoffMgr::get_peer(SatLinkHead* slhp)
 	return ( (SatNode*) remote_phy_->head()->node());
 }
 
+//////////////////////////////////////////////////////////////////////////
+// class SatSnapshot
+//////////////////////////////////////////////////////////////////////////
+
+SatSnapshot::SatSnapshot() : n_(0), node_(0), coord_(0), x_(0), y_(0), 
+    z_(0), rate_(0), gen_(0), size_(0), time_(-1)
+{
+}
+
+void SatSnapshot::alloc(int n)
+{
+	delete [] node_;
+	delete [] coord_;
+	delete [] x_;
+	delete [] y_;
+	delete [] z_;
+	delete [] rate_;
+	size_ = n;
+	node_ = new SatNode*[n];
+	coord_ = new coordinate[n];
+	x_ = new double[n];
+	y_ = new double[n];
+	z_ = new double[n];
+	rate_ = new double[n];
+}
+
+void SatSnapshot::update()
+{
+	Node *nodep;
+	SatNode *snodep;
+	int i, n = 0;
+
+	if (time_ == NOW + SatPosition::time_advance_)
+		return;
+	time_ = NOW + SatPosition::time_advance_;
+	for (nodep = Node::nodehead_.lh_first; nodep; 
+	    nodep = nodep->nextnode()) {
+		if (!SatNode::IsASatNode(nodep->address()))
+			continue;
+		snodep = (SatNode*) nodep;
+		if (snodep->position() && 
+		    snodep->position()->type() == POSITION_SAT_POLAR)
+			n++;
+	}
+	if (n > size_) {
+		alloc(n);
+		gen_++;
+	}
+	i = 0;
+	for (nodep = Node::nodehead_.lh_first; nodep; 
+	    nodep = nodep->nextnode()) {
+		if (!SatNode::IsASatNode(nodep->address()))
+			continue;
+		snodep = (SatNode*) nodep;
+		if (!snodep->position() || 
+		    snodep->position()->type() != POSITION_SAT_POLAR)
+			continue;
+		if (i >= n_ || node_[i] != snodep)
+			gen_++;
+		node_[i] = snodep;
+		coord_[i] = snodep->position()->coord();
+		SatGeometry::spherical_to_cartesian(coord_[i].r, 
+		    coord_[i].theta, coord_[i].phi, x_[i], y_[i], z_[i]);
+		rate_[i] = 2 * PI / snodep->position()->period();
+		i++;
+	}
+	if (n != n_)
+		gen_++;
+	n_ = n;
+}
+
 //////////////////////////////////////////////////////////////////////////
 // class TermLinkHandoffMgr
 //////////////////////////////////////////////////////////////////////////
 
 double TermLinkHandoffMgr::elevation_mask_ = 0;
 int TermLinkHandoffMgr::term_handoff_int_ = 10;
+SatSnapshot TermLinkHandoffMgr::snapshot_;
 
-TermLinkHandoffMgr::TermLinkHandoffMgr() : timer_(this)
+TermLinkHandoffMgr::TermLinkHandoffMgr() : timer_(this), quiet_time_(0),
+    quiet_(-1), quiet_mask_(0), quiet_gen_(-1)
 {
 	bind("elevation_mask_", &elevation_mask_);
 	bind("term_handoff_int_", &term_handoff_int_);
 }
 
+//
+// Find the polar satellite with the highest elevation above the mask, 
+// or return 0 (and set elev to 0) if there is none.
+//
+// When there is none, also work out how long it will take at least
+// before any satellite can rise above the mask: a satellite is above
+// the mask only if the angle, at the center of the Earth, between it
+// and the terminal is below
+//	gamma_max = acos(E cos(mask) / S) - mask
+// and that angle cannot change faster than the satellite's orbital
+// speed plus the terminal's speed due to the Earth's rotation.  Until
+// then scans are skipped; they would find nothing.
+//
+SatNode* TermLinkHandoffMgr::scan(coordinate earth_coord, double mask_,
+    double& elev)
+{
+	SatNode *best_peer_ = 0;
+	double best_found_elev_ = 0;
+	double found_elev_;
+	double t_x, t_y, t_z;
+	double now = NOW + SatPosition::time_advance_;
+	int i;
+
+	elev = 0;
+	snapshot_.update();
+	if (quiet_gen_ == snapshot_.gen_ && quiet_mask_ == mask_ &&
+	    fabs(now - quiet_time_) < quiet_)
+		return 0;
+	SatGeometry::spherical_to_cartesian(earth_coord.r, earth_coord.theta,
+	    earth_coord.phi, t_x, t_y, t_z);
+	for (i = 0; i < snapshot_.n_; i++) {
+		found_elev_ = SatGeometry::check_elevation(snapshot_.x_[i],
+		    snapshot_.y_[i], snapshot_.z_[i], snapshot_.coord_[i].r,
+		    t_x, t_y, t_z, mask_);
+		if (found_elev_ > best_found_elev_) {
+			best_peer_ = snapshot_.node_[i];
+			best_found_elev_ = found_elev_;
+		}
+	}
+	if (best_peer_) {
+		elev = best_found_elev_;
+		return best_peer_;
+	}
+	double m = (mask_ > 0) ? mask_ : 0;
+	double E = EARTH_RADIUS;
+	double T = sqrt(t_x * t_x + t_y * t_y + t_z * t_z);
+	double term_rate = 2 * PI / ((SatNode*)node_)->position()->period();
+	quiet_ = -1;
+	for (i = 0; i < snapshot_.n_; i++) {
+		double S = snapshot_.coord_[i].r;
+		double c = (snapshot_.x_[i] * t_x + snapshot_.y_[i] * t_y +
+		    snapshot_.z_[i] * t_z) / (S * T);
+		if (c > 1)
+			c = 1;
+		if (c < -1)
+			c = -1;
+		// 1e-6 rad of slack covers the rounding in check_elevation
+		double margin = acos(c) - (acos(E * cos(m) / S) - m) - 1e-6;
+		// Right at the branch points of PolarSatPosition::coord(), 
+		// the position it returns may be off the orbit.
+		double a = ((PolarSatPosition*)
+		    snapshot_.node_[i]->position())->phase();
+		if (fabs(a - PI/2) < 1e-6 || fabs(a - 3*PI/2) < 1e-6)
+			margin = 0;
+		double t = (margin > 0) ? 
+		    margin / (snapshot_.rate_[i] + term_rate) : 0;
+		if (quiet_ < 0 || t < quiet_)
+			quiet_ = t;
+	}
+	quiet_time_ = now;
+	quiet_mask_ = mask_;
+	quiet_gen_ = snapshot_.gen_;
+	return 0;
+}
+
 // 
 // This is called each time the node checks to see if its link to a
 // polar satellite needs to be handed off.  
@@ -211,12 +359,10 @@ int TermLinkHandoffMgr::handoff()
 	SatLinkHead* slhp;
 	SatNode *peer_; // Polar satellite at opposite end of the GSL
 	SatNode *best_peer_ = 0; // Best found peer for handoff
-	Node *nodep;  // Pointer used in searching the list of nodes
 	PolarSatPosition *nextpos_;
 	int link_changes_flag_ = FALSE; // Flag indicating change took place 
 	int restart_timer_flag_ = FALSE; // Restart timer only if polar links
 	double found_elev_ = 0;  //``Flag'' indicates whether handoff can occur 
-	double best_found_elev_ = 0; 
 	double mask_ = DEG_TO_RAD(TermLinkHandoffMgr::elevation_mask_);
 
 	earth_coord = ((SatNode *)node_)->position()->coord();
@@ -276,28 +422,10 @@ int TermLinkHandoffMgr::handoff()
 			}
 			// Next, check all remaining satellites if not found
 			if (!found_elev_) {
-				for (nodep=Node::nodehead_.lh_first; nodep;
-				    nodep = nodep->nextnode()) {
-					if (!SatNode::IsASatNode(nodep->address()))
-						continue;
-					peer_ = (SatNode*) nodep;
-					if (peer_->position() && 
-					    (peer_->position()->type() != 
-					    POSITION_SAT_POLAR))
-						    continue;
-					sat_coord = 
-					    peer_->position()->coord();
-					found_elev_ = SatGeometry::check_elevation(sat_coord, earth_coord, mask_);
-					if (found_elev_ > best_found_elev_) {
-					    best_peer_ = peer_;
-					    best_found_elev_ = found_elev_;
-					}
-				}
-				if (best_found_elev_ > 0.0) {
-					assert (best_peer_ != 0);
+				best_peer_ = scan(earth_coord, mask_, 
+				    found_elev_);
+				if (best_peer_)
 					peer_ = best_peer_;
-					found_elev_ = best_found_elev_;
-				}
 			}
 			if (found_elev_) {
 				slhp->linkup_ = TRUE;
@@ -42,6 +42,7 @@
 #include "timer-handler.h"
 #include "rng.h"
 #include "node.h"
+#include "satgeometry.h"
 #include <math.h>
 
 // Handoff manager types
@@ -71,6 +72,27 @@ protected:
 class SatLinkHead;
 class SatNode;
 
+// Positions of all the polar satellites at the current time, shared by
+// the terminals that look for a satellite at the same instant so that
+// each position is only computed (and converted to cartesian) once.
+class SatSnapshot {
+public:
+	SatSnapshot();
+	void update();		// bring up to date for NOW
+	int n_;			// number of polar satellites, in node order
+	SatNode** node_;
+	coordinate* coord_;
+	double* x_;		// cartesian coordinates
+	double* y_;
+	double* z_;
+	double* rate_;		// orbital angular speed (rad/s)
+	int gen_;		// changes whenever the set of satellites does
+protected:
+	void alloc(int);
+	int size_;
+	double time_;		// NOW + time_advance_ of the positions
+};
+
 class LinkHandoffMgr : public TclObject {
 public:
 	LinkHandoffMgr();
@@ -106,9 +128,17 @@ public:
 	TermLinkHandoffMgr();
 	int handoff();
 protected:
+	SatNode* scan(coordinate, double, double&);
 	TermHandoffTimer timer_;
 	static double elevation_mask_;
 	static int term_handoff_int_;
+	static SatSnapshot snapshot_;
+	// No satellite can rise above the mask while the simulated time
+	// (plus time_advance_) is within quiet_ of quiet_time_.
+	double quiet_time_;
+	double quiet_;
+	double quiet_mask_;	// for this mask,
+	int quiet_gen_;		// and this SatSnapshot generation
 };
 
 #endif
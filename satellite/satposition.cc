@@ -291,6 +291,16 @@ bool PolarSatPosition::isascending()
 	}
 }
 
+//
+// Current angle of the satellite from the ascending node, from 0 to 2*PI.
+// coord() switches branches at PI/2 and 3*PI/2.
+//
+double PolarSatPosition::phase()
+{
+	double partial = (fmod(NOW + time_advance_, period_)/period_) * 2*PI;
+	return (fmod(initial_.theta + partial, 2*PI));
+}
+
 int PolarSatPosition::command(int argc, const char*const* argv) {     
 	Tcl& tcl = Tcl::instance();
         if (argc == 2) {
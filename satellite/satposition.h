@@ -79,6 +79,7 @@ class PolarSatPosition : public SatPosition {
 	virtual coordinate coord();
 	void set(double Altitude, double Lon, double Alpha, double inclination=90); 
 	bool isascending();
+	double phase();
 	PolarSatPosition* next() { return next_; }
 	int plane() { return plane_; }
 
@@ -141,6 +141,8 @@ void SatRouteAgent::forwardPacket(Packet * p)
 	hdrc->last_hop_ = myaddr_; // for tracing purposes 
 	if (SatRouteObject::instance().data_driven_computation())
 		SatRouteObject::instance().recompute_node(myaddr_);
+	else
+		SatRouteObject::instance().flush();
 	if (SatNode::dist_routing_ == 0) {
 		if (slot_ == 0) { // No routes to anywhere
 			if (node_->trace())
@@ -207,7 +209,13 @@ static class SatRouteObjectClass:public TclClass
 
 SatRouteObject* SatRouteObject::instance_;
 
-SatRouteObject::SatRouteObject() : suppress_initial_computation_(0) 
+void SatRouteTimer::expire(Event*)
+{
+	a_->flush();
+}
+
+SatRouteObject::SatRouteObject() : suppress_initial_computation_(0),
+    pending_(0), timer_(this)
 {
 	bind_bool("wiredRouting_", &wiredRouting_);
 	bind_bool("metric_delay_", &metric_delay_);
@@ -230,9 +238,11 @@ int SatRouteObject::command (int argc, const char *const *argv)
 		}
 		if (strcmp(argv[1], "compute_routes") == 0) {
 			recompute();
+			flush();
 			return (TCL_OK);
 		}
 		if (strcmp(argv[1], "dump") == 0) {
+			flush();
 			printf("Dumping\n");
 			dump();
 			return (TCL_OK);
@@ -268,6 +278,16 @@ void SatRouteObject::recompute_node(int node)
 	node_compute_routes(node);
 	populate_routing_tables(node);
 }
+//
+// Handoffs call this each time they change a link.  With many terminals
+// and satellites, many handoffs happen at the same instant (the handoff
+// timers all fire on multiples of the handoff interval unless
+// randomized), so the computation is put off until the first packet
+// is forwarded or, at the latest, until the end of the current
+// instant.  Since the positions, and so the link delays, are the same
+// all through an instant, the routes are the same as if they had been
+// computed after every change, but they are computed once.
+//
 void SatRouteObject::recompute()
 {
 	// For very large topologies (e.g., Teledesic), we don't want to
@@ -276,15 +296,26 @@ void SatRouteObject::recompute()
 	if (data_driven_computation_ ||
 	    (NOW < 0.001 && suppress_initial_computation_) ) 
 		return;
-	else {
-		compute_topology();
-		if (wiredRouting_) {
-			Tcl::instance().evalf("[Simulator instance] compute-flat-routes");
-		} else {
-			compute_routes(); // base class function
-		}
-		populate_routing_tables();
+	else if (wiredRouting_)
+		recompute_now();
+	else if (!pending_) {
+		pending_ = 1;
+		timer_.resched(0);
+	}
+}
+
+void SatRouteObject::recompute_now()
+{
+	pending_ = 0;
+	if (timer_.status() == TIMER_PENDING)
+		timer_.cancel();
+	compute_topology();
+	if (wiredRouting_) {
+		Tcl::instance().evalf("[Simulator instance] compute-flat-routes");
+	} else {
+		compute_routes(); // base class function
 	}
+	populate_routing_tables();
 }
 
 // Derives link adjacency information from the nodes and gives the current
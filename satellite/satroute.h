@@ -42,6 +42,7 @@
 #include <agent.h>
 #include "route.h"
 #include "node.h"
+#include "timer-handler.h"
 
 #define ROUTER_PORT      0xff
 #define SAT_ROUTE_INFINITY 0x3fff
@@ -86,6 +87,16 @@ protected:
 
 ////////////////////////////////////////////////////////////////////////////
 
+class SatRouteObject;
+
+class SatRouteTimer : public TimerHandler {
+public:
+	SatRouteTimer(SatRouteObject *a) : TimerHandler() { a_ = a; }
+protected:
+	virtual void expire(Event *e);
+	SatRouteObject *a_;
+};
+
 // A global route computation object/genie  
 // This class performs operations very similar to what "Simulator instproc
 // compute-routes" does at OTcl-level, except it performs them entirely
@@ -98,6 +109,7 @@ public:
   }
   void recompute();
   void recompute_node(int node);
+  void flush() { if (pending_) recompute_now(); }
   int command(int argc, const char * const * argv);        
   int data_driven_computation() { return data_driven_computation_; } 
   void insert_link(int src, int dst, double cost);
@@ -106,6 +118,7 @@ public:
 //void hier_insert_link(int *src, int *dst, int cost);  // support hier-rtg?
 
 protected:
+  void recompute_now();
   void compute_topology();
   void populate_routing_tables(int node = -1);
   int lookup(int src, int dst);
@@ -118,6 +131,8 @@ protected:
   int suppress_initial_computation_;
   int data_driven_computation_;
   int wiredRouting_;
+  int pending_;		// recompute() called, routes not yet computed
+  SatRouteTimer timer_;
 };
 
 #endif
@@ -12,6 +12,15 @@ if [TclObject is-class Network/Pcap/Live] {
 	Network/Pcap/File set offset_ 0.0; # ts for 1st pkt in trace file
 }
 
+if [TclObject is-class Network/Packet/Ring] {
+	Network/Packet/Ring set blocksize_ 262144;# ring block size (bytes)
+	Network/Packet/Ring set nblocks_ 64;	# blocks in the RX ring
+	Network/Packet/Ring set txblocks_ 4;	# blocks in the TX ring
+	Network/Packet/Ring set framesize_ 2048;# TX frame size (bytes)
+	Network/Packet/Ring set timeout_ 0.001;	# RX block retire timeout
+	Network/Packet/Ring set promisc_ false
+}
+
 if [TclObject is-class Agent/Tap] {
     Agent/Tap set maxpkt_ 1600
 }
@@ -71,6 +71,7 @@ CMUTrace set radius_scaling_factor_ 1.0
 CMUTrace set duration_scaling_factor_ 3.0e4
 
 Scheduler/RealTime set maxslop_ 0.010; # max allowed slop b4 error (sec)
+Scheduler/RealTime set minwait_ 0.001; # shorter waits spin (sec)
 
 #
 # Queues and associated
@@ -356,9 +357,24 @@ DelayLink set debug_ false
 DelayLink set avoidReordering_ false ;	# Added 3/27/2003.
 					# Set to true to avoid reordering when
 					#   changing link bandwidth or delay.
+DelayLink set batch_ false ;		# Set to true to schedule only the
+					#   head of the packets in transit.
 DynamicLink set status_ 1
 DynamicLink set debug_ false
 
+FluidModel set nflows_ 0
+FluidModel set rtt_ 100ms
+FluidModel set pktsize_ 1000
+FluidModel set interval_ 1ms
+FluidModel set maxwin_ 64
+FluidModel set minth_ 0 ;		# maxth_ 0 means tail drop
+FluidModel set maxth_ 0
+FluidModel set maxp_ 0.1
+FluidModel set win_ 1
+FluidModel set qlen_ 0
+FluidModel set rate_ 0
+FluidModel set prob_ 0
+
 Filter set debug_ false
 Filter/Field set offset_ 0
 Filter/Field set match_  -1
@@ -372,7 +388,9 @@ Classifier set mask_ 0xffffffff
 Classifier set debug_ false
 
 Classifier/Hash set default_ -1; # none
+Classifier/Hier set cachesize_ 64
 Classifier/Replicator set ignore_ 0
+Classifier/Replicator set shareData_ true
 
 # MPLS Classifier
 Classifier/Addr/MPLS set ttl_   32
@@ -513,6 +531,7 @@ RandomVariable/Empirical set minCDF_ 0
 RandomVariable/Empirical set maxCDF_ 1
 RandomVariable/Empirical set interpolation_ 0
 RandomVariable/Empirical set maxEntry_ 32
+RandomVariable/Empirical set alias_ false
 RandomVariable/Normal set avg_ 0.0
 RandomVariable/Normal set std_ 1.0
 RandomVariable/LogNormal set avg_ 1.0
@@ -552,6 +571,12 @@ Node/MobileNode set delay_				0	;# not used
 Node/MobileNode set REGAGENT_PORT 0
 Node/MobileNode set DECAP_PORT 1
 
+# Centralized route computation
+RouteLogic set sparse_ false	;# CSR graph + per-source SPF, see route.cc
+RouteLogic set threads_ 1	;# threads used by the route computation
+RouteLogic set lazy_ false	;# compute the routes of a source on first use
+RouteLogic set cache_ 1024	;# sources whose routes lazy_ mode keeps
+
 
 # Default settings for Hierarchical topology
 #
@@ -673,6 +698,8 @@ Snoop set debug_ false
  Mac/802_11 set RTSThreshold_  0               ;# bytes
  Mac/802_11 set ShortRetryLimit_       7               ;# retransmittions
  Mac/802_11 set LongRetryLimit_        4               ;# retransmissions
+ Mac/802_11 set analyticBackoff_	false	;# don't reschedule the backoff
+						;# timer on every busy period
 
 
 
@@ -716,6 +743,13 @@ Phy/WirelessPhy set bandwidth_ 2e6
 Phy/WirelessPhy set Pt_ 0.28183815
 Phy/WirelessPhy set freq_ 914e+6
 Phy/WirelessPhy set L_ 1.0  
+Phy/WirelessPhy set sinr_ false ;		# SINR receiver model
+Phy/WirelessPhy set SINRThresh_ 10.0
+Phy/WirelessPhy set noise_ 1.0e-13 ;		# -100 dBm
+Phy/WirelessPhy set PLCPTime_ 192us
+Phy/WirelessPhy set linkCache_ false ;		# cache Pr per transmitter
+Channel/WirelessChannel set linkCache_ false ;	# cache receivers per
+						#   transmitter while static
 
 Phy/WiredPhy set bandwidth_ 10e6
 
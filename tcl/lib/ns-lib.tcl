@@ -1089,38 +1089,30 @@ Simulator instproc simplex-link { n1 n2 bw delay qtype args } {
 #
 # A poor hack. :( Any better ideas?
 #
+# The list is kept as an array from link to its position, so that
+# registering a link does not search all the links registered so far;
+# moving a link to the end of the list gives it a new position.
+#
 Simulator instproc register-nam-linkconfig link {
-	$self instvar linkConfigList_ link_
-	if [info exists linkConfigList_] {
-		# Check whether the reverse simplex link is registered,
-		# if so, don't register this link again.
-		# We should have a separate object for duplex link.
-		set i1 [[$link src] id]
-		set i2 [[$link dst] id]
-		if [info exists link_($i2:$i1)] {
-			set pos [lsearch $linkConfigList_ $link_($i2:$i1)]
-			if {$pos >= 0} {
-				set a1 [$link_($i2:$i1) get-attribute \
-						"ORIENTATION"]
-				set a2 [$link get-attribute "ORIENTATION"]
-				if {$a1 == "" && $a2 != ""} {
-					# If this duplex link has not been 
-					# assigned an orientation, do it.
-					set linkConfigList_ [lreplace \
-						$linkConfigList_ $pos $pos]
-				} else {
-					return
-				}
-			}
-		}
-		# Remove $link from list if it's already there
-		set pos [lsearch $linkConfigList_ $link]
-		if {$pos >= 0} {
-			set linkConfigList_ \
-					[lreplace $linkConfigList_ $pos $pos]
+	$self instvar linkConfigList_ linkConfigN_ link_
+	# Check whether the reverse simplex link is registered,
+	# if so, don't register this link again.
+	# We should have a separate object for duplex link.
+	set i1 [[$link src] id]
+	set i2 [[$link dst] id]
+	if {[info exists link_($i2:$i1)] && \
+	    [info exists linkConfigList_($link_($i2:$i1))]} {
+		set a1 [$link_($i2:$i1) get-attribute "ORIENTATION"]
+		set a2 [$link get-attribute "ORIENTATION"]
+		if {$a1 == "" && $a2 != ""} {
+			# If this duplex link has not been 
+			# assigned an orientation, do it.
+			unset linkConfigList_($link_($i2:$i1))
+		} else {
+			return
 		}
 	}
-	lappend linkConfigList_ $link
+	set linkConfigList_($link) [incr linkConfigN_]
 }
 
 #
@@ -1129,17 +1121,11 @@ Simulator instproc register-nam-linkconfig link {
 #
 Simulator instproc remove-nam-linkconfig {i1 i2} {
 	$self instvar linkConfigList_ link_
-	if ![info exists linkConfigList_] {
-		return
-	}
-	set pos [lsearch $linkConfigList_ $link_($i1:$i2)]
-	if {$pos >= 0} {
-		set linkConfigList_ [lreplace $linkConfigList_ $pos $pos]
-		return
-	}
-	set pos [lsearch $linkConfigList_ $link_($i2:$i1)]
-	if {$pos >= 0} {
-		set linkConfigList_ [lreplace $linkConfigList_ $pos $pos]
+	if [info exists linkConfigList_($link_($i1:$i2))] {
+		unset linkConfigList_($link_($i1:$i2))
+	} elseif {[info exists link_($i2:$i1)] && \
+		  [info exists linkConfigList_($link_($i2:$i1))]} {
+		unset linkConfigList_($link_($i2:$i1))
 	}
 }
 
@@ -1205,6 +1191,56 @@ Simulator instproc duplex-intserv-link { n1 n2 bw pd sched signal adc args } {
 	eval $self duplex-link $n1 $n2 $bw $pd intserv $sched $signal $adc $args
 }
 
+#
+# Build a topology from a file with one record per line:
+#
+#	nodes <n>
+#	simplex-link <id1> <id2> <bw> <delay> <qtype> ?<args>?
+#	duplex-link <id1> <id2> <bw> <delay> <qtype> ?<args>?
+#
+# where "nodes" creates nodes until there are n of them, and nodes are
+# named by id.  Blank lines and lines starting with # are ignored.  The
+# objects are the same as those made by the commands themselves.
+#
+Simulator instproc read-topology { file } {
+	$self instvar Node_
+	set f [open $file]
+	set lineno 0
+	while { [gets $f line] >= 0 } {
+		incr lineno
+		set line [string trim $line]
+		if { $line == "" || [string index $line 0] == "#" } {
+			continue
+		}
+		set op [lindex $line 0]
+		switch -exact -- $op {
+			nodes {
+				set n [lindex $line 1]
+				while { [Node set nn_] < $n } {
+					$self node
+				}
+			}
+			simplex-link -
+			duplex-link {
+				set i1 [lindex $line 1]
+				set i2 [lindex $line 2]
+				if { ![info exists Node_($i1)] || \
+				    ![info exists Node_($i2)] } {
+					close $f
+					error "$file:$lineno: no node $i1 or $i2"
+				}
+				eval $self $op $Node_($i1) $Node_($i2) \
+				    [lrange $line 3 end]
+			}
+			default {
+				close $f
+				error "$file:$lineno: unknown record $op"
+			}
+		}
+	}
+	close $f
+}
+
 Simulator instproc simplex-link-op { n1 n2 op args } {
 	$self instvar link_
 	eval $link_([$n1 id]:[$n2 id]) $op $args
@@ -1732,6 +1768,48 @@ Simulator instproc all-nodes-list {} {
 	return $nodes
 }
 
+#
+# Run n replications of the simulation set up so far, at most jobs at
+# a time, in forked children that share the topology copy-on-write.
+# Each replication draws from its own RNG substreams.  Returns the
+# replication number in the child; the parent exits once all of them
+# are done.
+#
+Simulator instproc replicate { n {jobs 1} } {
+	foreach ch [file channels] {
+		catch { flush $ch }
+	}
+	set rep [$self cmd replicate $n $jobs]
+	if { $rep < 0 } {
+		exit [expr $rep == -1 ? 0 : 1]
+	}
+	return $rep
+}
+
+#
+# Park the simulation at the Unix socket path, typically at the end of
+# a warm-up phase.  Every "$ns restore path script", run from another
+# ns process, branches a variant off this state in which the script is
+# evaluated (at global level) and the simulation then carries on, with
+# the stdin, stdout and stderr of that process; restore returns the
+# variant's exit status.  The checkpointed process itself exits once
+# "$ns restore path {}" stops it.
+#
+Simulator instproc checkpoint { path } {
+	foreach ch [file channels] {
+		catch { flush $ch }
+	}
+	set script [$self cmd checkpoint $path]
+	if { $script == "" } {
+		exit 0
+	}
+	uplevel #0 $script
+}
+
+Simulator instproc restore { path script } {
+	$self cmd restore $path $script
+}
+
 Simulator instproc link { n1 n2 } {
         $self instvar Node_ link_
         if { ![catch "$n1 info class Node"] } {
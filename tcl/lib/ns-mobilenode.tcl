@@ -65,12 +65,20 @@ Node/MobileNode instproc init args {
 	set X_ 0.0
 	set Y_ 0.0
 	set Z_ 0.0
+	# the link caches must see positions set from Tcl
+	foreach v {X_ Y_ Z_} {
+		trace variable $v w "$self position-changed"
+	}
         set arptable_ ""                ;# no ARP table yet
 	set nifs_	0		;# number of network interfaces
 	# Mobile IP node processing
         $self makemip-New$nodetype_
 }
 
+Node/MobileNode instproc position-changed args {
+	$self cmd position-changed
+}
+
 #----------------------------------------------------------------------
 
 # XXX Following are the last remnant of nodetype_. Need to be completely 
@@ -480,8 +480,13 @@ Simulator instproc dump-namlinks {} {
 		return
 	}
 	if [info exists linkConfigList_] {
-		foreach lnk $linkConfigList_ {
-			$lnk dump-namconfig
+		# in the order of registration
+		set l {}
+		foreach {lnk pos} [array get linkConfigList_] {
+			lappend l [list $pos $lnk]
+		}
+		foreach e [lsort -integer -index 0 $l] {
+			[lindex $e 1] dump-namconfig
 		}
 		unset linkConfigList_
 	}
@@ -7,6 +7,19 @@ Simulator instproc set-nix-routing { } {
     Node enable-module "Nix"
 }
 
+# Compute the nix-vectors of a set of flows, a list of {src dst} node
+# pairs, before the run instead of on the first packet of each flow.
+# The BFS trees are computed in the given number of threads.
+# The number of BFS trees cached between flows from the same source
+# can be set with "$ns nix-tree-cache <n>" (default 16).
+Simulator instproc nix-precompute { flows {threads 1} } {
+    set ids ""
+    foreach f $flows {
+	lappend ids [[lindex $f 0] id] [[lindex $f 1] id]
+    }
+    eval $self cmd nix-precompute $threads $ids
+}
+
 Simulator instproc get-link-head { n1 n2 } {
     $self instvar link_
     return [$link_($n1:$n2) head]
@@ -631,3 +631,11 @@ Queue/XCP instproc reset {} {
 	$vq_(1) reset
 	$vq_(2) reset
 }
+
+#
+# Couple a FluidModel of background traffic to the queue and the
+# delay element of a link.
+#
+FluidModel instproc attach-link { link } {
+	$self attach [$link queue] [$link link]
+}
@@ -357,7 +357,11 @@ Simulator instproc compute-flat-routes {} {
 	# classifier-population part moved to C++: this results in > 50% 
         # improvement of simulation run time.
 	
-	$self populate-flat-classifiers $n
+	if [$r set lazy_] {
+		$self lazy-flat-classifiers
+	} else {
+		$self populate-flat-classifiers $n
+	}
 	
 
 	# Set up each classifer (aka node) to act as a router.
@@ -391,6 +395,31 @@ Simulator instproc compute-flat-routes {} {
 	#	time: [clock format [clock seconds] -format %X]"
 }
 
+#
+# With RouteLogic lazy_ set, the routes of a node are looked up and
+# installed in its classifier only when it first forwards a packet to a
+# destination, by a LazyRoute object set as the classifier's default
+# target.  When the routes are recomputed, each node keeps its LazyRoute,
+# which removes the routes it installed so that they are looked up again.
+#
+Simulator instproc lazy-flat-classifiers {} {
+	$self instvar Node_ lazyRoute_
+	foreach i [array names Node_] {
+		if [info exists lazyRoute_($i)] {
+			$lazyRoute_($i) flush
+			continue
+		}
+		set m [$Node_($i) get-module Base]
+		if { $m == "" } {
+			continue
+		}
+		set lr [new LazyRoute]
+		$lr attach $Node_($i) [$m set classifier_]
+		[$m set classifier_] defaulttarget $lr
+		set lazyRoute_($i) $lr
+	}
+}
+
 Simulator instproc get-link-head { n1 n2 } {
     $self instvar link_
     return [$link_($n1:$n2) head]
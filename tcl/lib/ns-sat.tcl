@@ -795,6 +795,10 @@ HandoffManager set handoff_randomization_ false
 SatRouteObject set metric_delay_ true
 SatRouteObject set data_driven_computation_ false
 SatRouteObject set wiredRouting_ false
+SatRouteObject set sparse_ false; # routes need the link entries of adj_
+SatRouteObject set threads_ 1; # threads used by the route computation
+SatRouteObject set lazy_ false
+SatRouteObject set cache_ 1024
 Mac/Sat set trace_drops_ true
 Mac/Sat set trace_collisions_ true
 Mac/Sat/UnslottedAloha set mean_backoff_ 1s; # mean backoff time upon collision
@@ -0,0 +1,129 @@
+# This test suite checks that a DelayLink holding its packets in
+# transit in one queue (batch_ true) delivers them in the same order as
+# one that schedules every packet (batch_ false).
+#
+# To run all tests:  test-all-delay-batch
+#
+# To run individual tests:
+# ns test-suite-delay-batch.tcl batch
+# ns test-suite-delay-batch.tcl nobatch
+#
+# $n0 sends a UDP packet every 20ms over a 100ms link to $n1.  At
+# 0.29s the link delay drops to 10ms, so the packets sent from then on
+# overtake the five still in transit and have to be inserted among
+# them.  Both tests write the packets in the order $n1 got them to
+# temp.rands, so their reference outputs are identical.
+
+Class TestSuite
+
+TestSuite instproc init {} {
+	global rcvd
+	$self instvar ns_
+	set ns_ [new Simulator]
+	set n0 [$ns_ node]
+	set n1 [$ns_ node]
+	$ns_ simplex-link $n0 $n1 1Mb 100ms DropTail
+
+	set src [new Agent/UDP]
+	set rcvr [new Agent/UDP]
+	$ns_ attach-agent $n0 $src
+	$ns_ attach-agent $n1 $rcvr
+	$ns_ connect $src $rcvr
+	$rcvr proc process_data {size data} {
+		global rcvd
+		lappend rcvd $data
+	}
+	set rcvd ""
+
+	for {set k 0} {$k < 20} {incr k} {
+		$ns_ at [expr 0.1 + $k * 0.02] "$src send 500 $k"
+	}
+	$ns_ at 0.29 "[[$ns_ link $n0 $n1] link] set delay_ 10ms"
+	$ns_ at 1.0 "$self finish"
+}
+
+TestSuite instproc finish {} {
+	global rcvd
+	set f [open temp.rands w]
+	foreach k $rcvd {
+		puts $f $k
+	}
+	close $f
+	exit 0
+}
+
+TestSuite instproc run {} {
+	$self instvar ns_
+	$ns_ run
+}
+
+Class Test/batch -superclass TestSuite
+
+Test/batch instproc init {} {
+	DelayLink set batch_ true
+	$self next
+}
+
+Class Test/nobatch -superclass TestSuite
+
+Test/nobatch instproc init {} {
+	DelayLink set batch_ false
+	$self next
+}
+
+proc usage {} {
+	global argv0
+	puts stderr "usage: ns $argv0 <tests>"
+	puts stderr "Valid tests are:\t[get-subclasses TestSuite Test/]"
+	exit 1
+}
+
+proc isProc? {cls prc} {
+	if [catch "Object info subclass $cls/$prc" r] {
+		global argv0
+		puts stderr "$argv0: no such $cls: $prc"
+		usage
+	}
+}
+
+proc get-subclasses {cls pfx} {
+	set ret ""
+	set l [string length $pfx]
+
+	set c $cls
+	while {[llength $c] > 0} {
+		set t [lindex $c 0]
+		set c [lrange $c 1 end]
+		if [string match ${pfx}* $t] {
+			lappend ret [string range $t $l end]
+		}
+		eval lappend c [$t info subclass]
+	}
+	set ret
+}
+
+TestSuite proc runTest {} {
+	global argc argv quiet
+
+	set quiet false
+	switch $argc {
+		1 {
+			set test $argv
+			isProc? Test $test
+		}
+		2 {
+			set test [lindex $argv 0]
+			isProc? Test $test
+			if {[lindex $argv 1] == "QUIET"} {
+				set quiet true
+			}
+		}
+		default {
+			usage
+		}
+	}
+	set t [new Test/$test]
+	$t run
+}
+
+TestSuite runTest
@@ -162,6 +162,66 @@ Test/eqp instproc run {} {
 	$ns run
 }
 
+# Checks that the incremental shortest path computation of LS
+# (LsSpf) gives the same costs and next hop lists, in the same order,
+# as the full recomputation it replaced, while links fail and recover.
+# Only the outcome of the checks goes to temp.rands.
+Class Test/spf -superclass TestSuite
+
+Test/spf instproc init {} {
+	$self instvar ns n
+	set ns [new Simulator]
+	Node set multiPath_ 1
+	for {set i 0} {$i < 8} {incr i} {
+		set n($i) [$ns node]
+	}
+	# a ring with two chords; costs are picked so that several
+	# destinations have equal cost paths
+	foreach l {{0 1 1} {1 2 1} {2 3 2} {3 4 1} {4 5 1} {5 6 2}
+		   {6 7 1} {7 0 1} {0 4 3} {2 6 3}} {
+		set a [lindex $l 0]
+		set b [lindex $l 1]
+		$ns duplex-link $n($a) $n($b) 10Mb 2ms DropTail
+		$ns cost $n($a) $n($b) [lindex $l 2]
+		$ns cost $n($b) $n($a) [lindex $l 2]
+	}
+	$ns rtmodel-at 0.3 down $n(0) $n(1)
+	$ns rtmodel-at 0.5 down $n(4) $n(5)
+	$ns rtmodel-at 0.7 up $n(0) $n(1)
+	$ns rtmodel-at 0.9 down $n(2) $n(6)
+	$ns rtmodel-at 1.1 up $n(4) $n(5)
+	$ns rtmodel-at 1.3 up $n(2) $n(6)
+	$ns rtproto LS
+}
+
+Test/spf instproc check {} {
+	$self instvar n checks_ bad_
+	foreach i [array names n] {
+		set ls [[$n($i) rtObject?] rtProto? LS]
+		incr bad_ [$ls checkRoutes]
+		incr checks_
+	}
+}
+
+Test/spf instproc finish {} {
+	$self instvar checks_ bad_
+	set f [open temp.rands w]
+	puts $f "spf: $checks_ checks, $bad_ mismatches"
+	close $f
+	exit 0
+}
+
+Test/spf instproc run {} {
+	$self instvar ns checks_ bad_
+	set checks_ 0
+	set bad_ 0
+	for {set t 1} {$t <= 15} {incr t} {
+		$ns at [expr $t / 10.0 + 0.05] "$self check"
+	}
+	$ns at 1.6 "$self finish"
+	$ns run
+}
+
 proc usage {} {
 	global argv0
 	puts stderr "usage: ns $argv0 <tests>"
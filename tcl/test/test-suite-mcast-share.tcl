@@ -0,0 +1,150 @@
+# This test suite checks that multicast copies which share their
+# payload (Packet::copy_shared(), the default for Classifier/Replicator)
+# deliver the same data as copies made with Packet::copy().
+#
+# To run all tests:  test-all-mcast-share
+#
+# To run individual tests:
+# ns test-suite-mcast-share.tcl shared
+# ns test-suite-mcast-share.tcl copy
+#
+# Both tests write the sorted list of payloads each receiver got to
+# temp.rands, so their reference outputs are identical.
+#
+#	$n0 -- $n1 -- $n2
+#		 |
+#		$n3 -- $n4
+#		 |
+#		$n5
+#
+# $n0 sends; UDP agents on $n2, $n4 and $n5 read the data, a Null
+# agent on $n3 drops it without looking at it, and $n1 only forwards.
+
+Class TestSuite
+
+TestSuite instproc init {} {
+	global rcvd
+	$self instvar ns_ n_
+	set ns_ [new Simulator -multicast on]
+	for {set i 0} {$i < 6} {incr i} {
+		set n_($i) [$ns_ node]
+	}
+	$ns_ duplex-link $n_(0) $n_(1) 1.5Mb 10ms DropTail
+	$ns_ duplex-link $n_(1) $n_(2) 1.5Mb 10ms DropTail
+	$ns_ duplex-link $n_(1) $n_(3) 1.5Mb 10ms DropTail
+	$ns_ duplex-link $n_(3) $n_(4) 1.5Mb 10ms DropTail
+	$ns_ duplex-link $n_(3) $n_(5) 1.5Mb 10ms DropTail
+	$ns_ mrtproto DM {}
+
+	set group [Node allocaddr]
+	set src [new Agent/UDP]
+	$src set dst_addr_ $group
+	$src set dst_port_ 0
+	$ns_ attach-agent $n_(0) $src
+
+	foreach i {2 4 5} {
+		set rcvr [new Agent/UDP]
+		$ns_ attach-agent $n_($i) $rcvr
+		$rcvr proc process_data {size data} \
+		    "global rcvd; lappend rcvd($i) \$data"
+		set rcvd($i) ""
+		$ns_ at 0.1 "$n_($i) join-group $rcvr $group"
+	}
+	set null [new Agent/Null]
+	$ns_ attach-agent $n_(3) $null
+	$ns_ at 0.1 "$n_(3) join-group $null $group"
+
+	for {set k 0} {$k < 20} {incr k} {
+		$ns_ at [expr 0.5 + $k * 0.05] \
+		    "$src send 200 {payload $k [string repeat x [expr $k + 1]]}"
+	}
+	$ns_ at 2.0 "$self finish"
+}
+
+TestSuite instproc finish {} {
+	global rcvd
+	set f [open temp.rands w]
+	foreach i [lsort [array names rcvd]] {
+		foreach d [lsort $rcvd($i)] {
+			puts $f "$i $d"
+		}
+	}
+	close $f
+	exit 0
+}
+
+TestSuite instproc run {} {
+	$self instvar ns_
+	$ns_ run
+}
+
+Class Test/shared -superclass TestSuite
+
+Test/shared instproc init {} {
+	Classifier/Replicator set shareData_ true
+	$self next
+}
+
+Class Test/copy -superclass TestSuite
+
+Test/copy instproc init {} {
+	Classifier/Replicator set shareData_ false
+	$self next
+}
+
+proc usage {} {
+	global argv0
+	puts stderr "usage: ns $argv0 <tests>"
+	puts stderr "Valid tests are:\t[get-subclasses TestSuite Test/]"
+	exit 1
+}
+
+proc isProc? {cls prc} {
+	if [catch "Object info subclass $cls/$prc" r] {
+		global argv0
+		puts stderr "$argv0: no such $cls: $prc"
+		usage
+	}
+}
+
+proc get-subclasses {cls pfx} {
+	set ret ""
+	set l [string length $pfx]
+
+	set c $cls
+	while {[llength $c] > 0} {
+		set t [lindex $c 0]
+		set c [lrange $c 1 end]
+		if [string match ${pfx}* $t] {
+			lappend ret [string range $t $l end]
+		}
+		eval lappend c [$t info subclass]
+	}
+	set ret
+}
+
+TestSuite proc runTest {} {
+	global argc argv quiet
+
+	set quiet false
+	switch $argc {
+		1 {
+			set test $argv
+			isProc? Test $test
+		}
+		2 {
+			set test [lindex $argv 0]
+			isProc? Test $test
+			if {[lindex $argv 1] == "QUIET"} {
+				set quiet true
+			}
+		}
+		default {
+			usage
+		}
+	}
+	set t [new Test/$test]
+	$t run
+}
+
+TestSuite runTest
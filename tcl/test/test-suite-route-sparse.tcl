@@ -0,0 +1,171 @@
+# This test suite checks that the sparse, threaded and lazy route
+# computations of RouteLogic give the same next hops as the dense
+# compute_routes().
+#
+# To run all tests:  test-all-route-sparse
+#
+# To run individual tests:
+# ns test-suite-route-sparse.tcl sparse
+# ns test-suite-route-sparse.tcl sparse-unit
+# ns test-suite-route-sparse.tcl threads
+# ns test-suite-route-sparse.tcl lazy
+#
+# The topology is a ring of 30 nodes with chords, and one link goes
+# down halfway.  After each route computation, "check-routes" recomputes
+# the routes with compute_routes() and counts the pairs with a different
+# next hop; only that count goes to temp.rands.
+
+Class TestSuite
+
+TestSuite instproc init {} {
+	$self instvar ns_ n_ unit_ name_
+	set ns_ [new Simulator]
+	for {set i 0} {$i < 30} {incr i} {
+		set n_($i) [$ns_ node]
+	}
+	for {set i 0} {$i < 30} {incr i} {
+		$self add-link $i [expr ($i + 1) % 30] [expr 1 + $i % 3]
+		if {$i % 4 == 0} {
+			$self add-link $i [expr ($i * 7 + 11) % 30] [expr 2 + $i % 5]
+		}
+	}
+	# Session routing recomputes all the routes when the link
+	# goes down; it must not be used by either computation
+	$ns_ rtproto Session
+	$ns_ rtmodel-at 0.5 down $n_(3) $n_(4)
+	$ns_ at 0.1 "$self check"
+	$ns_ at 0.6 "$self check"
+	$ns_ at 1.0 "$self finish"
+}
+
+TestSuite instproc add-link {a b cost} {
+	$self instvar ns_ n_ unit_
+	if {$a == $b || [$ns_ link $n_($a) $n_($b)] != ""} {
+		return
+	}
+	$ns_ duplex-link $n_($a) $n_($b) 10Mb 2ms DropTail
+	if {!$unit_} {
+		$ns_ cost $n_($a) $n_($b) $cost
+		$ns_ cost $n_($b) $n_($a) $cost
+	}
+}
+
+TestSuite instproc check {} {
+	$self instvar ns_ bad_ checks_
+	incr bad_ [[$ns_ get-routelogic] check-routes]
+	incr checks_
+}
+
+TestSuite instproc finish {} {
+	$self instvar name_ bad_ checks_
+	set f [open temp.rands w]
+	puts $f "$name_: $checks_ checks, $bad_ mismatches"
+	close $f
+	exit 0
+}
+
+TestSuite instproc run {} {
+	$self instvar ns_ bad_ checks_
+	set bad_ 0
+	set checks_ 0
+	$ns_ run
+}
+
+Class Test/sparse -superclass TestSuite
+
+Test/sparse instproc init {} {
+	$self instvar unit_ name_
+	set unit_ 0
+	set name_ sparse
+	RouteLogic set sparse_ true
+	$self next
+}
+
+Class Test/sparse-unit -superclass TestSuite
+
+Test/sparse-unit instproc init {} {
+	$self instvar unit_ name_
+	set unit_ 1
+	set name_ sparse-unit
+	RouteLogic set sparse_ true
+	$self next
+}
+
+Class Test/threads -superclass TestSuite
+
+Test/threads instproc init {} {
+	$self instvar unit_ name_
+	set unit_ 0
+	set name_ threads
+	RouteLogic set sparse_ true
+	RouteLogic set threads_ 4
+	$self next
+}
+
+Class Test/lazy -superclass TestSuite
+
+Test/lazy instproc init {} {
+	$self instvar unit_ name_
+	set unit_ 0
+	set name_ lazy
+	RouteLogic set lazy_ true
+	RouteLogic set cache_ 8
+	$self next
+}
+
+proc usage {} {
+	global argv0
+	puts stderr "usage: ns $argv0 <tests>"
+	puts stderr "Valid tests are:\t[get-subclasses TestSuite Test/]"
+	exit 1
+}
+
+proc isProc? {cls prc} {
+	if [catch "Object info subclass $cls/$prc" r] {
+		global argv0
+		puts stderr "$argv0: no such $cls: $prc"
+		usage
+	}
+}
+
+proc get-subclasses {cls pfx} {
+	set ret ""
+	set l [string length $pfx]
+
+	set c $cls
+	while {[llength $c] > 0} {
+		set t [lindex $c 0]
+		set c [lrange $c 1 end]
+		if [string match ${pfx}* $t] {
+			lappend ret [string range $t $l end]
+		}
+		eval lappend c [$t info subclass]
+	}
+	set ret
+}
+
+TestSuite proc runTest {} {
+	global argc argv quiet
+
+	set quiet false
+	switch $argc {
+		1 {
+			set test $argv
+			isProc? Test $test
+		}
+		2 {
+			set test [lindex $argv 0]
+			isProc? Test $test
+			if {[lindex $argv 1] == "QUIET"} {
+				set quiet true
+			}
+		}
+		default {
+			usage
+		}
+	}
+	set t [new Test/$test]
+	$t run
+}
+
+TestSuite runTest
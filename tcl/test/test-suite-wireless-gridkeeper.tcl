@@ -42,6 +42,11 @@ Class TestSuite
 Class Test/dsdv -superclass TestSuite
 # wireless model using destination sequence distance vector
 
+Class Test/fanout -superclass TestSuite
+# static nodes with a gridkeeper radius covering the whole grid, so
+# every transmission goes through the channel's receiver list to all
+# other nodes.  Writes the delivery count of each flow to temp.rands.
+
 #Class Test/dsr -superclass TestSuite
 # wireless model using dynamic source routing
 
@@ -49,7 +54,7 @@ Class Test/dsdv -superclass TestSuite
 proc usage {} {
 	global argv0
 	puts stderr "usage: ns $argv0 <tests> "
-	puts "Valid Tests: dsdv dsr"
+	puts "Valid Tests: dsdv fanout dsr"
 	exit 1
 }
 
@@ -221,6 +226,73 @@ Test/dsdv instproc run {} {
     $ns_ run
 }
 
+Test/fanout instproc init {} {
+    global opt node_
+    $self instvar ns_ src_ rcvr_
+
+    set opt(nn) 16
+    set opt(radius) 1000
+    set ns_ [new Simulator]
+    set topo [new Topography]
+    $topo load_flatgrid $opt(x) $opt(y)
+    $self create-god $opt(nn)
+    $ns_ node-config -adhocRouting DumbAgent \
+		     -llType $opt(ll) \
+		     -macType $opt(mac) \
+		     -ifqType $opt(ifq) \
+		     -ifqLen $opt(ifqlen) \
+		     -antType $opt(ant) \
+		     -propType $opt(prop) \
+		     -phyType $opt(netif) \
+		     -channel [new $opt(chan)] \
+		     -topoInstance $topo \
+		     -agentTrace OFF \
+		     -routerTrace OFF \
+		     -macTrace OFF
+    # a 4x4 grid with 100m spacing, all within carrier sense range
+    for {set i 0} {$i < $opt(nn)} {incr i} {
+	set node_($i) [$ns_ node]
+	$node_($i) random-motion 0
+	$node_($i) set X_ [expr 100.0 + 100 * ($i % 4)]
+	$node_($i) set Y_ [expr 100.0 + 100 * ($i / 4)]
+	$node_($i) set Z_ 0.0
+    }
+    $self create_gridkeeper
+
+    # one flow at a time, so there are no collisions
+    set k 0
+    foreach {s d} {0 1  5 6  10 11  15 14  3 6} {
+	set src_($k) [new Agent/UDP]
+	set rcvr_($k) [new Agent/LossMonitor]
+	$ns_ attach-agent $node_($s) $src_($k)
+	$ns_ attach-agent $node_($d) $rcvr_($k)
+	$ns_ connect $src_($k) $rcvr_($k)
+	set cbr [new Application/Traffic/CBR]
+	$cbr set packetSize_ 512
+	$cbr set interval_ 0.05
+	$cbr set maxpkts_ 10
+	$cbr attach-agent $src_($k)
+	$ns_ at [expr 1.0 + 2 * $k] "$cbr start"
+	incr k
+    }
+    $ns_ at 12.0 "$self finish-fanout $k"
+}
+
+Test/fanout instproc finish-fanout {n} {
+    $self instvar rcvr_
+    set f [open temp.rands w]
+    for {set k 0} {$k < $n} {incr k} {
+	puts $f "flow $k: [$rcvr_($k) set npkts_]/10"
+    }
+    close $f
+    exit 0
+}
+
+Test/fanout instproc run {} {
+    $self instvar ns_
+    $ns_ run
+}
+
 #Test/dsr instproc init {} {
 	#$self instvar ns_ testName_ 
 	#set testName_ dsr
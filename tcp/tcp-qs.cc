@@ -254,7 +254,7 @@ QSNewRenoTcpAgent::send_much(int force, int reason, int maxburst)
 		// Conservatively set the congestion window to min of
 		// congestion window and the smoothed rbwin_reno
 		RBP_DEBUG_PRINTF(("cwnd before check = %g\n", double(cwnd_)));
-		cwnd_ = MIN(cwnd_,(TracedDouble) rbwin_reno);
+		cwnd_ = MIN(cwnd_,(TcpTracedDouble) rbwin_reno);
 		RBP_DEBUG_PRINTF(("cwnd after check = %g\n", double(cwnd_)));
 		RBP_DEBUG_PRINTF(("recv win = %g\n", wnd_));
 		// RBP timer calculations must be based on the actual
@@ -364,23 +364,23 @@ TcpAgent::traceVar(TracedVar* v)
 	curtime = &s ? s.clock() : 0;
 
 	// XXX comparing addresses is faster than comparing names
-	if (v == &cwnd_)
+	if (v == TCP_TRACEDVAR(cwnd_))
 		snprintf(wrk, TCP_WRK_SIZE,
 			 "%-8.5f %-2d %-2d %-2d %-2d %s %-6.3f\n",
 			 curtime, addr(), port(), daddr(), dport(),
 			 v->name(), double(*((TracedDouble*) v))); 
- 	else if (v == &t_rtt_)
+ 	else if (v == TCP_TRACEDVAR(t_rtt_))
 		snprintf(wrk, TCP_WRK_SIZE,
 			 "%-8.5f %-2d %-2d %-2d %-2d %s %-6.3f\n",
 			 curtime, addr(), port(), daddr(), dport(),
 			 v->name(), int(*((TracedInt*) v))*tcp_tick_); 
-	else if (v == &t_srtt_)
+	else if (v == TCP_TRACEDVAR(t_srtt_))
 		snprintf(wrk, TCP_WRK_SIZE,
 			 "%-8.5f %-2d %-2d %-2d %-2d %s %-6.3f\n",
 			 curtime, addr(), port(), daddr(), dport(),
 			 v->name(), 
 			 (int(*((TracedInt*) v)) >> T_SRTT_BITS)*tcp_tick_); 
-	else if (v == &t_rttvar_)
+	else if (v == TCP_TRACEDVAR(t_rttvar_))
 		snprintf(wrk, TCP_WRK_SIZE,
 			 "%-8.5f %-2d %-2d %-2d %-2d %s %-6.3f\n",
 			 curtime, addr(), port(), daddr(), dport(),
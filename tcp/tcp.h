@@ -124,6 +124,23 @@ struct hdr_tcp {
 #define TCP_TIMER_Q         4
 #define TCP_TIMER_RESET        5 
 
+/*
+ * The TCP state variables (cwnd_, t_seqno_, ...) are TracedInt and
+ * TracedDouble so that they can be traced from Tcl ("$tcp trace
+ * cwnd_").  With TCP_UNTRACED_VARS defined they are plain ints and
+ * doubles: every update is then a single store rather than a store and
+ * a tracer check, and they can still be bound but no longer traced.
+ */
+#ifdef TCP_UNTRACED_VARS
+typedef int TcpTracedInt;
+typedef double TcpTracedDouble;
+#define TCP_TRACEDVAR(v)	((TracedVar*)0)
+#else
+typedef TracedInt TcpTracedInt;
+typedef TracedDouble TcpTracedDouble;
+#define TCP_TRACEDVAR(v)	((TracedVar*)&(v))
+#endif
+
 class TcpAgent;
 
 class RtxTimer : public TimerHandler {
@@ -194,16 +211,16 @@ protected:
 	virtual void delay_bind_init_all();
 	virtual int delay_bind_dispatch(const char *varName, const char *localName, TclObject *tracer);
 
-	TracedInt t_seqno_;	/* sequence number */
+	TcpTracedInt t_seqno_;	/* sequence number */
 	/*
 	 * State encompassing the round-trip-time estimate.
 	 * srtt and rttvar are stored as fixed point;
 	 * srtt has 3 bits to the right of the binary point, rttvar has 2.
 	 */
-	TracedInt t_rtt_;      	/* round trip time */
-	TracedInt t_srtt_;     	/* smoothed round-trip time */
-	TracedInt t_rttvar_;   	/* variance in round-trip time */
-	TracedInt t_backoff_;	/* current multiplier, 1 if not backed off */
+	TcpTracedInt t_rtt_;      	/* round trip time */
+	TcpTracedInt t_srtt_;     	/* smoothed round-trip time */
+	TcpTracedInt t_rttvar_;   	/* variance in round-trip time */
+	TcpTracedInt t_backoff_;	/* current multiplier, 1 if not backed off */
 	#define T_RTT_BITS 0
 	int T_SRTT_BITS;        /* exponent of weight for updating t_srtt_ */
 	int srtt_init_;		/* initial value for computing t_srtt_ */
@@ -355,12 +372,12 @@ protected:
 	/*
 	 * Dynamic state.
 	 */
-	TracedInt dupacks_;	/* number of duplicate acks */
-	TracedInt curseq_;	/* highest seqno "produced by app" */
-	TracedInt highest_ack_;	/* not frozen during Fast Recovery */
-	TracedDouble cwnd_;	/* current window */
-	TracedInt ssthresh_;	/* slow start threshold */
-	TracedInt maxseq_;	/* used for Karn algorithm */
+	TcpTracedInt dupacks_;	/* number of duplicate acks */
+	TcpTracedInt curseq_;	/* highest seqno "produced by app" */
+	TcpTracedInt highest_ack_;	/* not frozen during Fast Recovery */
+	TcpTracedDouble cwnd_;	/* current window */
+	TcpTracedInt ssthresh_;	/* slow start threshold */
+	TcpTracedInt maxseq_;	/* used for Karn algorithm */
 				/* highest seqno sent so far */
 	int last_ack_;		/* largest consecutive ACK, frozen during
 				 *		Fast Recovery */
@@ -388,18 +405,18 @@ protected:
 	int trace_all_oneline_;	/* TCP tracing vars all in one line or not? */
 	int nam_tracevar_;      /* Output nam's variable trace or just plain 
 				   text variable trace? */
-        TracedInt ndatapack_;   /* number of data packets sent */
-        TracedInt ndatabytes_;  /* number of data bytes sent */
-        TracedInt nackpack_;    /* number of ack packets received */
-        TracedInt nrexmit_;     /* number of retransmit timeouts 
+        TcpTracedInt ndatapack_;   /* number of data packets sent */
+        TcpTracedInt ndatabytes_;  /* number of data bytes sent */
+        TcpTracedInt nackpack_;    /* number of ack packets received */
+        TcpTracedInt nrexmit_;     /* number of retransmit timeouts 
 				   when there was data outstanding */
-        TracedInt nrexmitpack_; /* number of retransmited packets */
-        TracedInt nrexmitbytes_; /* number of retransmited bytes */
-        TracedInt necnresponses_; /* number of times cwnd was reduced
+        TcpTracedInt nrexmitpack_; /* number of retransmited packets */
+        TcpTracedInt nrexmitbytes_; /* number of retransmited bytes */
+        TcpTracedInt necnresponses_; /* number of times cwnd was reduced
 			   	   in response to an ecn packet -- sylvia */
-        TracedInt ncwndcuts_; 	/* number of times cwnd was reduced 
+        TcpTracedInt ncwndcuts_; 	/* number of times cwnd was reduced 
 				   for any reason -- sylvia */
-        TracedInt ncwndcuts1_;     /* number of times cwnd was reduced 
+        TcpTracedInt ncwndcuts1_;     /* number of times cwnd was reduced 
                                    due to congestion (as opposed to idle
                                    periods */
 	/* end of dynamic state for monitoring */
@@ -411,7 +428,7 @@ protected:
 				   timeouts during a connection's idle period.
 				   Setting this boolean fixes this problem.
 				   For now, it is off by default. */ 
-        TracedInt singledup_;   /* Send on a single dup ack.  */
+        TcpTracedInt singledup_;   /* Send on a single dup ack.  */
 	int LimTransmitFix_;	/* To fix a bug in Limited Transmit. */
 	int noFastRetrans_;	/* No Fast Retransmit option.  */
 	int oldCode_;		/* Use old code. */
@@ -63,6 +63,22 @@ int RandomVariable::command(int argc, const char*const* argv)
 		}
 	}
 	if (argc == 3) {
+		if (strcmp(argv[1], "values") == 0) {
+			int n = atoi(argv[2]);
+			if (n <= 0)
+				return (TCL_OK);
+			double* v = new double[n];
+			char* buf = new char[n * 24 + 1];
+			char* p = buf;
+			values(v, n);
+			*p = 0;
+			for (int i = 0; i < n; i++)
+				p += sprintf(p, i ? " %6e" : "%6e", v[i]);
+			Tcl_SetResult(tcl.interp(), buf, TCL_VOLATILE);
+			delete [] buf;
+			delete [] v;
+			return (TCL_OK);
+		}
 		if (strcmp(argv[1], "use-rng") == 0) {
 			rng_ = (RNG*)TclObject::lookup(argv[2]);
 			if (rng_ == 0) {
@@ -75,6 +91,12 @@ int RandomVariable::command(int argc, const char*const* argv)
 	return(TclObject::command(argc, argv));
 }
 
+void RandomVariable::values(double* v, int n)
+{
+	for (int i = 0; i < n; i++)
+		v[i] = value();
+}
+
 // Added by Debojyoti Dutta 12 October 2000
 // This allows us to seed a randomvariable with 
 // our own RNG object. This command is called from 
@@ -119,6 +141,13 @@ double UniformRandomVariable::value()
 	return(rng_->uniform(min_, max_));
 }
 
+void UniformRandomVariable::values(double* v, int n)
+{
+	rng_->uniform_block(v, n);
+	for (int i = 0; i < n; i++)
+		v[i] = min_ + (max_ - min_) * v[i];
+}
+
 
 static class ExponentialRandomVariableClass : public TclClass {
 public:
@@ -143,6 +172,11 @@ double ExponentialRandomVariable::value()
 	return(rng_->exponential(avg_));
 }
 
+void ExponentialRandomVariable::values(double* v, int n)
+{
+	rng_->exponential_block(v, n, avg_);
+}
+
 
 static class ParetoRandomVariableClass : public TclClass {
  public:
@@ -176,6 +210,14 @@ double ParetoRandomVariable::value()
 	return(rng_->pareto(avg_ * (shape_ -1)/shape_, shape_));
 }
 
+void ParetoRandomVariable::values(double* v, int n)
+{
+	double scale = avg_ * (shape_ - 1) / shape_;
+	rng_->uniform_block(v, n);
+	for (int i = 0; i < n; i++)
+		v[i] = scale * (1.0 / pow(v[i], 1.0 / shape_));
+}
+
 /* Pareto distribution of the second kind, aka. Lomax distribution */
 static class ParetoIIRandomVariableClass : public TclClass {
  public:
@@ -321,12 +363,21 @@ public:
 	}
 } class_empiricalranvar;
 
-EmpiricalRandomVariable::EmpiricalRandomVariable() : minCDF_(0), maxCDF_(1), maxEntry_(32), table_(0)
+EmpiricalRandomVariable::EmpiricalRandomVariable() : minCDF_(0), maxCDF_(1), maxEntry_(32), table_(0), guide_(0), alias_(0), aprob_(0), aalias_(0)
 {
 	bind("minCDF_", &minCDF_);
 	bind("maxCDF_", &maxCDF_);
 	bind("interpolation_", &interpolation_);
 	bind("maxEntry_", &maxEntry_);
+	bind_bool("alias_", &alias_);
+}
+
+EmpiricalRandomVariable::~EmpiricalRandomVariable()
+{
+	delete [] table_;
+	delete [] guide_;
+	delete [] aprob_;
+	delete [] aalias_;
 }
 
 int EmpiricalRandomVariable::command(int argc, const char*const* argv)
@@ -372,13 +423,103 @@ int EmpiricalRandomVariable::loadCDF(const char* filename)
 		sscanf(line, "%lf %*f %lf", &e->val_, &e->cdf_);
 	}
         fclose(fp);
+	build_guide();
+	delete [] aprob_;
+	aprob_ = 0;
 	return numEntry_;
 }
 
+void EmpiricalRandomVariable::build_guide()
+{
+	delete [] guide_;
+	guide_ = 0;
+	if (numEntry_ < 2)
+		return;
+	for (int i = 1; i < numEntry_; i++)
+		if (table_[i].cdf_ < table_[i-1].cdf_)
+			return;
+	glo_ = table_[0].cdf_;
+	double range = table_[numEntry_-1].cdf_ - glo_;
+	if (range <= 0)
+		return;
+	gscale_ = numEntry_ / range;
+	guide_ = new int[numEntry_];
+	int i = 1;
+	for (int k = 0; k < numEntry_; k++) {
+		double b = glo_ + k / gscale_;
+		while (i < numEntry_-1 && table_[i].cdf_ < b)
+			i++;
+		guide_[k] = i;
+	}
+}
+
+/*
+ * Entry i is drawn by lookup() for u in (cdf_[i-1], cdf_[i]] (entry 0
+ * below cdf_[0], the last one above cdf_[numEntry_-1]), so its
+ * probability is the part of [minCDF_, maxCDF_] in that interval.
+ */
+void EmpiricalRandomVariable::build_alias()
+{
+	int n = numEntry_, i;
+	delete [] aprob_;
+	delete [] aalias_;
+	aprob_ = new double[n];
+	aalias_ = new int[n];
+	amin_ = minCDF_;
+	amax_ = maxCDF_;
+	double range = maxCDF_ - minCDF_;
+	for (i = 0; i < n; i++) {
+		double a = (i == 0) ? minCDF_ : table_[i-1].cdf_;
+		double b = (i == n - 1) ? maxCDF_ : table_[i].cdf_;
+		if (a < minCDF_)
+			a = minCDF_;
+		if (b > maxCDF_)
+			b = maxCDF_;
+		aprob_[i] = (b > a && range > 0) ? n * (b - a) / range : 0;
+		aalias_[i] = i;
+	}
+	// pair each column short of 1 with one over 1 that tops it up
+	int* small = new int[n];
+	int* large = new int[n];
+	int ns = 0, nl = 0;
+	for (i = 0; i < n; i++) {
+		if (aprob_[i] < 1)
+			small[ns++] = i;
+		else
+			large[nl++] = i;
+	}
+	while (ns > 0 && nl > 0) {
+		int s = small[--ns];
+		int l = large[nl - 1];
+		aalias_[s] = l;
+		aprob_[l] -= 1 - aprob_[s];
+		if (aprob_[l] < 1) {
+			nl--;
+			small[ns++] = l;
+		}
+	}
+	// what is left is 1 up to rounding
+	while (nl > 0)
+		aprob_[large[--nl]] = 1;
+	while (ns > 0)
+		aprob_[small[--ns]] = 1;
+	delete [] small;
+	delete [] large;
+}
+
 double EmpiricalRandomVariable::value()
 {
 	if (numEntry_ <= 0)
 		return 0;
+	if (alias_ && interpolation_ == INTER_DISCRETE) {
+		if (aprob_ == 0 || amin_ != minCDF_ || amax_ != maxCDF_)
+			build_alias();
+		double x = rng_->uniform(double(numEntry_));
+		int i = int(x);
+		if (i >= numEntry_)
+			i = numEntry_ - 1;
+		return table_[x - i < aprob_[i] ? i : aalias_[i]].val_;
+	}
 	double u = rng_->uniform(minCDF_, maxCDF_);
 	int mid = lookup(u);
 	if (mid && interpolation_ && u < table_[mid].cdf_)
@@ -401,6 +542,18 @@ int EmpiricalRandomVariable::lookup(double u)
 	int lo, hi, mid;
 	if (u <= table_[0].cdf_)
 		return 0;
+	if (guide_ != 0) {
+		// the same entry as the binary search below
+		int k = int((u - glo_) * gscale_);
+		if (k >= numEntry_)
+			k = numEntry_ - 1;
+		lo = guide_[k];
+		while (lo > 1 && table_[lo-1].cdf_ >= u)
+			lo--;
+		while (lo < numEntry_-1 && table_[lo].cdf_ < u)
+			lo++;
+		return lo;
+	}
 	for (lo=1, hi=numEntry_-1;  lo < hi; ) {
 		mid = (lo + hi) / 2;
 		if (u > table_[mid].cdf_)
@@ -56,6 +56,8 @@ class RandomVariable : public TclObject {
  public:
 	virtual double value() = 0;
 	virtual double avg() = 0;
+	// n values at once; the same as n calls of value()
+	virtual void values(double* v, int n);
 	int command(int argc, const char*const* argv);
 	RandomVariable();
 	// This is added by Debojyoti Dutta 12th Oct 2000
@@ -67,6 +69,7 @@ class RandomVariable : public TclObject {
 class UniformRandomVariable : public RandomVariable {
  public:
 	virtual double value();
+	virtual void values(double* v, int n);
 	virtual inline double avg() { return (max_-min_)/2; };
 	UniformRandomVariable();
 	UniformRandomVariable(double, double);
@@ -84,6 +87,7 @@ class UniformRandomVariable : public RandomVariable {
 class ExponentialRandomVariable : public RandomVariable {
  public:
 	virtual double value();
+	virtual void values(double* v, int n);
 	ExponentialRandomVariable();
 	ExponentialRandomVariable(double);
 	double* avgp() { return &avg_; };
@@ -96,6 +100,7 @@ class ExponentialRandomVariable : public RandomVariable {
 class ParetoRandomVariable : public RandomVariable {
  public:
 	virtual double value();
+	virtual void values(double* v, int n);
 	ParetoRandomVariable();
 	ParetoRandomVariable(double, double);
 	double* avgp() { return &avg_; };
@@ -203,6 +208,7 @@ public:
 	virtual double interpolate(double u, double x1, double y1, double x2, double y2);
 	virtual double avg(){ return value(); } // junk
 	EmpiricalRandomVariable();
+	~EmpiricalRandomVariable();
 	double& minCDF() { return minCDF_; }
 	double& maxCDF() { return maxCDF_; }
 	int loadCDF(const char* filename);
@@ -210,6 +216,8 @@ public:
 protected:
 	int command(int argc, const char*const* argv);
 	int lookup(double u);
+	void build_guide();
+	void build_alias();
 
 	double minCDF_;		// min value of the CDF (default to 0)
 	double maxCDF_;		// max value of the CDF (default to 1)
@@ -217,6 +225,22 @@ protected:
 	int numEntry_;		// number of entries in the CDF table
 	int maxEntry_;		// size of the CDF table (mem allocation)
 	CDFentry* table_;	// CDF table of (val_, cdf_)
+
+	// Guide table: guide_[k] is the first entry whose cdf_ reaches
+	// the start of the k-th of numEntry_ equal buckets of the CDF
+	// range, so lookup() only scans a bucket (null if the CDF is
+	// not increasing).
+	int* guide_;
+	double glo_;		// cdf_ of the first entry
+	double gscale_;		// buckets per unit of cdf_
+
+	// Alias method (Walker; Vose's construction) for discrete CDFs
+	// when alias_ is set: one uniform picks a column i, kept with
+	// probability aprob_[i], else replaced by aalias_[i].
+	int alias_;
+	double* aprob_;
+	int* aalias_;
+	double amin_, amax_;	// minCDF_ and maxCDF_ the table is for
 };
 
 #endif
@@ -190,6 +190,34 @@ public:
 
 RNG* RNG::default_ = NULL;
 
+void
+RNG::uniform_block(double* u, int n)
+{
+#ifndef OLD_RNG
+	if (philox_ && !inc_prec_ && !anti_) {
+		int i = 0;
+		while (i < n) {
+			if (pidx_ == 4)
+				philox_next();
+			while (pidx_ < 4 && i < n)
+				u[i++] = (pout_[pidx_++] + 0.5) * 
+					2.3283064365386962890625e-10;
+		}
+		return;
+	}
+#endif /* !OLD_RNG */
+	for (int i = 0; i < n; i++)
+		u[i] = uniform();
+}
+
+void
+RNG::exponential_block(double* x, int n, double r)
+{
+	uniform_block(x, n);
+	for (int i = 0; i < n; i++)
+		x[i] = -r * log(x[i]);
+}
+
 double
 RNG::normal(double avg, double std)
 {
@@ -290,7 +318,19 @@ RNG::command(int argc, const char*const* argv)
 			return(TCL_OK);
 		}
 		//#endif
-	} else if (argc == 4) {
+	}
+#ifndef OLD_RNG
+	/*
+	 * $rng philox <stream> ?<seed>?
+	 * Use the counter-based generator, with the given stream.
+	 */
+	if ((argc == 3 || argc == 4) && strcmp(argv[1], "philox") == 0) {
+		set_philox(strtoul(argv[2], NULL, 0),
+			   argc == 4 ? strtoul(argv[3], NULL, 0) : 0);
+		return (TCL_OK);
+	}
+#endif /* !OLD_RNG */
+	if (argc == 4) {
 		if (strcmp(argv[1], "seed") == 0) {
 			int s = atoi(argv[3]);
 			if (strcmp(argv[2], "raw") == 0) {
@@ -528,6 +568,13 @@ namespace
 	const double two17 = 131072.0; 
 	const double two53 = 9007199254740992.0; 
 	const double fact = 5.9604644775390625e-8; /* 1 / 2^24 */ 
+	const double two32n = 2.3283064365386962890625e-10; /* 1 / 2^32 */ 
+
+	/* Philox4x32 multipliers and Weyl key increments */
+	const unsigned int ph_m0 = 0xD2511F53U; 
+	const unsigned int ph_m1 = 0xCD9E8D57U; 
+	const unsigned int ph_w0 = 0x9E3779B9U; 
+	const unsigned int ph_w1 = 0xBB67AE85U; 
 
 	// The following are the transition matrices of the two MRG 
 	// components (in matrix form), raised to the powers -1, 1, 
@@ -731,6 +778,12 @@ double RNG::U01 ()
 { 
 	long k; 
 	double p1, p2, u; 
+	if (philox_) { 
+		if (pidx_ == 4) 
+			philox_next(); 
+		u = (pout_[pidx_++] + 0.5) * two32n; 
+		return (anti_ == false) ? u : (1 - u); 
+	} 
 	/* Component 1 */ 
 	p1 = a12 * Cg_[1] - a13n * Cg_[0]; 
 	k = static_cast<long> (p1 / m1); 
@@ -748,6 +801,41 @@ double RNG::U01 ()
 	return (anti_ == false) ? u : (1 - u); 
 } 
 
+//------------------------------------------------------------------------- 
+// Philox4x32-10: ten rounds of two 32x32->64 bit multiplies, bumping
+// the key by the Weyl increments between rounds.  pctr_[0..2] count
+// the blocks of the substream pctr_[3].
+// 
+void RNG::philox_next () 
+{ 
+	unsigned int c0 = pctr_[0], c1 = pctr_[1], c2 = pctr_[2], c3 = pctr_[3]; 
+	unsigned int k0 = pkey_[0], k1 = pkey_[1]; 
+	for (int r = 0; r < 10; r++) { 
+		unsigned long long p0 = (unsigned long long)ph_m0 * c0; 
+		unsigned long long p1 = (unsigned long long)ph_m1 * c2; 
+		c0 = (unsigned int)(p1 >> 32) ^ c1 ^ k0; 
+		c1 = (unsigned int)p1; 
+		c2 = (unsigned int)(p0 >> 32) ^ c3 ^ k1; 
+		c3 = (unsigned int)p0; 
+		k0 += ph_w0; 
+		k1 += ph_w1; 
+	} 
+	pout_[0] = c0; pout_[1] = c1; pout_[2] = c2; pout_[3] = c3; 
+	pidx_ = 0; 
+	if (++pctr_[0] == 0 && ++pctr_[1] == 0) 
+		++pctr_[2]; 
+} 
+
+void RNG::set_philox (unsigned long stream, unsigned long seed) 
+{ 
+	philox_ = true; 
+	pkey_[0] = (unsigned int)stream; 
+	pkey_[1] = (unsigned int)seed; 
+	for (int i = 0; i < 4; ++i) 
+		pctr_[i] = 0; 
+	pidx_ = 4; 
+} 
+
 //------------------------------------------------------------------------- 
 // Generate the next random number with extended (53 bits) precision. 
 // 
@@ -781,6 +869,7 @@ double RNG::U01d ()
  */
 RNG::RNG (long seed) 
 {
+	enroll();
 	set_seed (seed);
 	init();
 }
@@ -789,6 +878,7 @@ void RNG::init()
 {
 	anti_ = false; 
 	inc_prec_ = false; 
+	philox_ = false; 
 
 	/* Information on a stream. The arrays {Cg_, Bg_, Ig_} contain the
 	   current state of the stream, the starting state of the current
@@ -851,6 +941,7 @@ double RNG::next_seed_[6] =
 // 
 RNG::RNG (const char *s) 
 { 
+	enroll();
 	if (strlen (s) > 99) {
 		strncpy (name_, s, 99);
 		name_[100] = 0;
@@ -862,11 +953,48 @@ RNG::RNG (const char *s)
 }
 
 
+//------------------------------------------------------------------------- 
+// destructor 
+// 
+RNG::~RNG () 
+{ 
+	for (RNG** p = &all_; *p != 0; p = &(*p)->next_rng_) 
+		if (*p == this) {
+			*p = next_rng_;
+			break;
+		}
+	if (default_ == this)
+		default_ = NULL;
+} 
+
+RNG* RNG::all_ = NULL;
+
+void RNG::enroll () 
+{ 
+	next_rng_ = all_;
+	all_ = this;
+} 
+
+//------------------------------------------------------------------------- 
+// Advance every RNG n substreams, for independent replications. 
+// 
+void RNG::next_substream_all (int n) 
+{ 
+	for (RNG* r = all_; r != 0; r = r->next_rng_) 
+		for (int i = 0; i < n; i++) 
+			r->reset_next_substream();
+} 
+
 //------------------------------------------------------------------------- 
 // Reset Stream to beginning of Stream. 
 // 
 void RNG::reset_start_stream () 
 { 
+	if (philox_) { 
+		pctr_[0] = pctr_[1] = pctr_[2] = pctr_[3] = 0; 
+		pidx_ = 4; 
+		return; 
+	} 
 	for (int i = 0; i < 6; ++i) 
 		Cg_[i] = Bg_[i] = Ig_[i]; 
 } 
@@ -876,6 +1004,11 @@ void RNG::reset_start_stream ()
 // 
 void RNG::reset_start_substream () 
 { 
+	if (philox_) { 
+		pctr_[0] = pctr_[1] = pctr_[2] = 0; 
+		pidx_ = 4; 
+		return; 
+	} 
 	for (int i = 0; i < 6; ++i) 
 		Cg_[i] = Bg_[i]; 
 } 
@@ -885,6 +1018,12 @@ void RNG::reset_start_substream ()
 // 
 void RNG::reset_next_substream () 
 { 
+	if (philox_) { 
+		pctr_[0] = pctr_[1] = pctr_[2] = 0; 
+		pctr_[3]++; 
+		pidx_ = 4; 
+		return; 
+	} 
 	MatVecModM(A1p76, Bg_, Bg_, m1); 
 	MatVecModM(A2p76, &Bg_[3], &Bg_[3], m2); 
 	for (int i = 0; i < 6; ++i) 
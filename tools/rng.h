@@ -119,7 +119,12 @@ public:
 	double next_double();
 #endif /* OLD_RNG */
 
+#ifdef OLD_RNG
 	RNG(RNGSources source, int seed = 1) { set_seed(source, seed); };
+#else
+	RNG(RNGSources source, int seed = 1) { enroll(); set_seed(source, seed); };
+	~RNG();
+#endif /* OLD_RNG */
 	void set_seed(RNGSources source, int seed = 1);
 	inline static RNG* defaultrng() { return (default_); }
 
@@ -127,6 +132,13 @@ public:
 	/*
 	 * Added for new RNG
 	 */
+	static void next_substream_all (int n);
+	/*
+	  Advances every RNG in existence n substreams, i.e. calls
+	  reset_next_substream() n times on each.  Gives each replication
+	  of a batch run (Simulator replicate) its own independent numbers.
+	*/
+
 	static void set_package_seed (const unsigned long seed[6]); 
 	/*
 	  Sets the initial seed s 0 of the package to the six integers in the
@@ -155,6 +167,17 @@ public:
 	  is computed, and C g and B g are set to N g .
 	*/
 
+	void set_philox (unsigned long stream, unsigned long seed = 0); 
+	/*
+	  Switches this RNG from MRG32k3a to the counter-based Philox4x32-10
+	  generator (Salmon et al., SC 2011), with the given stream number
+	  (32 bits) and seed (32 bits) as its key.  Any stream can be
+	  selected directly, so e.g. per-node or per-flow streams need no
+	  jumping ahead; each has 2^32 substreams of 2^98 numbers, with the
+	  Reset* methods above working as for MRG32k3a.  The seed methods
+	  (set_seed(), "seed") switch back to MRG32k3a.
+	*/
+
 	void set_antithetic (bool a); 
 	/*
 	  If a = true, the stream will start generating antithetic variates,
@@ -271,6 +294,10 @@ public:
 	{ return (-log(uniform())); }
 	inline double exponential(double r)
 	{ return (r * exponential());}
+	// n variates at once, for generators that need many of them;
+	// the same numbers as n calls of uniform() or exponential(r)
+	void uniform_block(double* u, int n);
+	void exponential_block(double* x, int n, double r = 1.0);
 	// See "Wide-area traffic: the failure of poisson modeling", Vern 
 	// Paxson and Sally Floyd, IEEE/ACM Transaction on Networking, 3(3),
 	// pp. 226-244, June 1995, on characteristics of counting processes 
@@ -315,6 +342,26 @@ protected:   // need to be public?
 	  be created (instantiated).
 	*/
 
+	bool philox_; 
+	unsigned int pkey_[2], pctr_[4], pout_[4]; 
+	int pidx_; 
+	/*
+	  Philox state: the key, the counter of the next block and the
+	  current block of four numbers, pidx_ of which have been used.
+	*/
+
+	void philox_next (); 
+	/*
+	  Computes the next block of four numbers.
+	*/
+
+	void enroll ();
+	static RNG* all_;
+	RNG* next_rng_;
+	/*
+	  List of all the RNG objects, for next_substream_all().
+	*/
+
 	double U01 (); 
 	/*
 	  The backbone uniform random number generator. 